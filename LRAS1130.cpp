@@ -19,10 +19,8 @@
 #include "LRAS1130.h"
 
 
-#include <Arduino.h>
-
-
 #ifdef ARDUINO_ARCH_AVR
+#include <avr/pgmspace.h>
 // Make it compatible with the standart
 #include <string.h>
 namespace std { using ::memset; } 
@@ -32,6 +30,16 @@ namespace std { using ::memcpy; }
 #endif
 
 
+#ifdef LRAS1130_INSTRUMENTATION
+/// Mark all transactions in the current function for the given operation.
+///
+#define LRAS1130_OPERATION(operation) \
+  const AS1130Instrumentation::Scope instrumentationScope(_instrumentation, AS1130Instrumentation::Operation##operation)
+#else
+#define LRAS1130_OPERATION(operation)
+#endif
+
+
 /// @mainpage
 ///
 /// @section intro_sec Introduction
@@ -44,14 +52,46 @@ namespace std { using ::memcpy; }
 /// @section requirements_sec Requirements
 ///
 /// This library is writte for Arduino compatible chips. It requires a 
-/// modern C++ compiler (C++11). The code also uses the "Wire" library 
+/// modern C++ compiler (C++11). By default, the code uses the "Wire" library 
 /// from the Arduino project for the I2C communication.
 ///
 /// @section classes_sec Classes
 ///
-/// There is only the lr::AS1130 class. Read the documentation of this class
+/// The main class is lr::AS1130. Read the documentation of this class
 /// for all details.
 ///
+/// All communication with the chip is done using the lr::AS1130Bus interface.
+/// The lr::AS1130WireBus class implements it for the Wire library. For host
+/// builds without Arduino, the lr::AS1130RecordingBus class records all
+/// transactions, which is useful to measure the bus usage of your code.
+/// The lr::AS1130Simulator class simulates a chip on the host and renders
+/// the displayed frames as ASCII art or PPM images.
+///
+/// The lr::AS1130FrameData and lr::AS1130GammaTable structures are
+/// generated at compile time and can be stored in program memory.
+///
+/// The lr::AS1130StreamPlayer class plays animations of any length by
+/// refilling the on/off frames of the chip while the movie is running.
+///
+/// Compressed animations are decoded with lr::AS1130AnimationDecoder.
+///
+/// The lr::AS1130MoviePlanner class selects the RAM configuration and
+/// assigns the frames and PWM sets of a sequence.
+///
+/// The lr::AS1130Display class combines up to 16 chips into one
+/// framebuffer.
+///
+/// The lr::AS1130ChipGroup bus sends identical writes to many chips.
+///
+/// The lr::AS1130TransactionQueue bus queues all writes and sends them
+/// from your main loop.
+///
+/// The lr::AS1130InterruptDispatcher class calls handlers for the
+/// interrupts signalled on the IRQ pin.
+///
+/// The lr::AS1130Instrumentation bus measures the communication for each
+/// function and register bank, if `LRAS1130_INSTRUMENTATION` is defined.
+///
 
 
 /// @brief The namespace for all Lucky Resistor classes and types.
@@ -66,82 +106,150 @@ namespace {
 ///
 const uint8_t cRegisterSelectionAddress = 0xfd;
 
+/// The value used if the currently selected register bank is not known.
+///
+const uint8_t cRegisterSelectionUnknown = 0xff;
+
+
+/// Read a byte from RAM or program memory.
+///
+/// @param data The pointer to the data.
+/// @param index The index of the byte.
+/// @param isProgramMemory True if the data is stored in program memory.
+/// @return The byte.
+///
+inline uint8_t readDataByte(const uint8_t *data, uint8_t index, bool isProgramMemory)
+{
+#ifdef ARDUINO_ARCH_AVR
+  if (isProgramMemory) {
+    return pgm_read_byte(data + index);
+  }
+#else
+  (void)isProgramMemory;
+#endif
+  return data[index];
+}
+
   
 }
 
 
+#ifdef ARDUINO
 AS1130::AS1130(ChipAddress chipAddress)
-  : _chipAddress(chipAddress)
+  : AS1130(AS1130WireBus::getDefault(), chipAddress)
+{
+}
+#endif
+
+
+AS1130::AS1130(AS1130Bus &bus, ChipAddress chipAddress)
+  : _bus(&bus),
+    _chipAddress(chipAddress),
+    _selectedRegister(cRegisterSelectionUnknown),
+    _isControlRegisterCacheEnabled(false),
+    _controlRegisterCacheValid(0),
+    _maximumTransactionSize(0),
+    _frameShadow(nullptr),
+    _frameShadowCount(0),
+    _gammaTable(nullptr),
+    _isPwmDotCorrectionEnabled(false),
+    _isStatusSnapshotValid(false),
+    _retryCount(0),
+    _lastError(AS1130Bus::StatusSuccess)
 {
+#ifdef LRAS1130_INSTRUMENTATION
+  _instrumentation = nullptr;
+#endif
+  invalidateFrameShadow();
 }
 
 
 bool AS1130::isChipConnected()
 {
-  Wire.beginTransmission(_chipAddress); 
-  Wire.write(cRegisterSelectionAddress); 
-  Wire.write(RS_NOP); 
-  return Wire.endTransmission() == 0; 
+  LRAS1130_OPERATION(IsChipConnected);
+  _bus->beginTransmission(_chipAddress); 
+  _bus->write(cRegisterSelectionAddress); 
+  _bus->write(RS_NOP); 
+  if (endTransmission() != AS1130Bus::StatusSuccess) {
+    return false;
+  }
+  _selectedRegister = RS_NOP;
+  return true;
 }
 
 
 void AS1130::setRamConfiguration(RamConfiguration ramConfiguration)
 {
+  LRAS1130_OPERATION(SetRamConfiguration);
   writeControlRegisterBits(CR_Config, CF_MemoryConfigMask, ramConfiguration);
 }
 
 
 void AS1130::setOnOffFrame(uint8_t frameIndex, const AS1130Picture12x11 &picture, uint8_t pwmSetIndex)
 {
+  LRAS1130_OPERATION(SetOnOffFrame);
   // Prepare all register bytes.
   const uint8_t registerDataSize = 0x18;
   uint8_t registerData[registerDataSize];
   AS1130Picture12x11::writeRegisters(registerData, picture.getData(), pwmSetIndex);
   // Write the bytes
-  const uint8_t frameAddress = (RS_OnOffFrame + frameIndex);
-  writeToMemory(frameAddress, 0x00, registerData, registerDataSize);
+  writeFrame(frameIndex, registerData, false);
 }
 
 
 void AS1130::setOnOffFrame(uint8_t frameIndex, const AS1130Picture24x5 &picture, uint8_t pwmSetIndex)
 {
+  LRAS1130_OPERATION(SetOnOffFrame);
   // Prepare all register bytes.
   const uint8_t registerDataSize = 0x18;
   uint8_t registerData[registerDataSize];
   AS1130Picture24x5::writeRegisters(registerData, picture.getData(), pwmSetIndex);
   // Write the bytes
-  const uint8_t frameAddress = (RS_OnOffFrame + frameIndex);
-  writeToMemory(frameAddress, 0x00, registerData, registerDataSize);
+  writeFrame(frameIndex, registerData, false);
 }
 
 
 void AS1130::setOnOffFrame24x5(uint8_t frameIndex, const uint8_t *data, uint8_t pwmSetIndex)
 {
+  LRAS1130_OPERATION(SetOnOffFrame24x5);
   // Prepare all register bytes.
   const uint8_t registerDataSize = 0x18;
   uint8_t registerData[registerDataSize];
   AS1130Picture24x5::writeRegisters(registerData, data, pwmSetIndex);
   // Write the bytes
-  const uint8_t frameAddress = (RS_OnOffFrame + frameIndex);
-  writeToMemory(frameAddress, 0x00, registerData, registerDataSize);
+  writeFrame(frameIndex, registerData, false);
 }
 
 
 void AS1130::setOnOffFrame12x11(uint8_t frameIndex, const uint8_t *data, uint8_t pwmSetIndex)
 {
+  LRAS1130_OPERATION(SetOnOffFrame12x11);
   // Prepare all register bytes.
   const uint8_t registerDataSize = 0x18;
   uint8_t registerData[registerDataSize];
   AS1130Picture12x11::writeRegisters(registerData, data, pwmSetIndex);
   // Write the bytes
-  const uint8_t frameAddress = (RS_OnOffFrame + frameIndex);
-  writeToMemory(frameAddress, 0x00, registerData, registerDataSize);
+  writeFrame(frameIndex, registerData, false);
+}
+
+
+void AS1130::setOnOffFrameRaw(uint8_t frameIndex, const AS1130FrameData &frameData)
+{
+  LRAS1130_OPERATION(SetOnOffFrameRaw);
+  writeFrame(frameIndex, frameData.registers, false);
+}
+
+
+void AS1130::setOnOffFrameRaw_P(uint8_t frameIndex, const AS1130FrameData *frameData)
+{
+  LRAS1130_OPERATION(SetOnOffFrameRaw_P);
+  writeFrame(frameIndex, frameData->registers, true);
 }
 
 
 void AS1130::setOnOffFrameAllOff(uint8_t frameIndex, uint8_t pwmSetIndex)
 {
-  const uint8_t frameAddress = (RS_OnOffFrame + frameIndex);
+  LRAS1130_OPERATION(SetOnOffFrameAllOff);
   // Prepare all frame bytes.
   const uint8_t registerDataSize = 0x18;
   uint8_t registerData[registerDataSize];
@@ -149,13 +257,13 @@ void AS1130::setOnOffFrameAllOff(uint8_t frameIndex, uint8_t pwmSetIndex)
   // Write the first segment with the PWM set index.
   registerData[1] = (pwmSetIndex<<5);
   // Send to chip.
-  writeToMemory(frameAddress, 0x00, registerData, registerDataSize);
+  writeFrame(frameIndex, registerData, false);
 }
 
 
 void AS1130::setOnOffFrameAllOn(uint8_t frameIndex, uint8_t pwmSetIndex)
 {
-  const uint8_t frameAddress = (RS_OnOffFrame + frameIndex);
+  LRAS1130_OPERATION(SetOnOffFrameAllOn);
   // Prepare all frame bytes.
   const uint8_t registerDataSize = 0x18;
   uint8_t registerData[registerDataSize];
@@ -168,28 +276,129 @@ void AS1130::setOnOffFrameAllOn(uint8_t frameIndex, uint8_t pwmSetIndex)
     registerData[i*2+1] = 0x07;
   }
   // Send to chip.
-  writeToMemory(frameAddress, 0x00, registerData, registerDataSize);
+  writeFrame(frameIndex, registerData, false);
 }
 
 
 void AS1130::setBlinkAndPwmSetAll(uint8_t setIndex, bool doesBlink, uint8_t pwmValue)
 {
+  LRAS1130_OPERATION(SetBlinkAndPwmSetAll);
   const uint8_t setAddress = (RS_BlinkAndPwmSet + setIndex);
   if (doesBlink) {
     fillMemory(setAddress, 0x00, 0xff, 24);
   } else {
     fillMemory(setAddress, 0x00, 0x00, 24);
   }
-  // Set all PWM values to the maximum.
-  fillMemory(setAddress, 0x18, pwmValue, 132);
+  if (_isPwmDotCorrectionEnabled) {
+    uint8_t pwmData[cPwmDataSize];
+    std::memset(pwmData, pwmValue, cPwmDataSize);
+    writePwmSet(setIndex, pwmData);
+  } else {
+    fillMemory(setAddress, 0x18, getCorrectedPwmValue(0, pwmValue), 132);
+  }
 }
 
 
 void AS1130::setPwmValue(uint8_t setIndex, uint8_t ledIndex, uint8_t value)
 {
+  LRAS1130_OPERATION(SetPwmValue);
+  const uint8_t setAddress = (RS_BlinkAndPwmSet + setIndex);
+  const uint8_t address = cPwmDataAddress + getPwmDataIndex(ledIndex);
+  writeToMemory(setAddress, address, getCorrectedPwmValue(ledIndex, value));
+}
+
+
+void AS1130::setPwmSet(uint8_t setIndex, const uint8_t *pwmData)
+{
+  LRAS1130_OPERATION(SetPwmSet);
+  if (isPwmCorrectionEnabled()) {
+    uint8_t correctedData[cPwmDataSize];
+    std::memcpy(correctedData, pwmData, cPwmDataSize);
+    writePwmSet(setIndex, correctedData);
+  } else {
+    const uint8_t setAddress = (RS_BlinkAndPwmSet + setIndex);
+    writeToMemory(setAddress, cPwmDataAddress, pwmData, cPwmDataSize);
+  }
+}
+
+
+void AS1130::setPwmSet12x11(uint8_t setIndex, const uint8_t *values)
+{
+  LRAS1130_OPERATION(SetPwmSet12x11);
+  uint8_t pwmData[cPwmDataSize];
+  for (uint8_t y = 0; y < AS1130Picture12x11::getHeight(); ++y) {
+    for (uint8_t x = 0; x < AS1130Picture12x11::getWidth(); ++x) {
+      pwmData[getPwmDataIndex(getLedIndex12x11(x, y))] = *values;
+      ++values;
+    }
+  }
+  writePwmSet(setIndex, pwmData);
+}
+
+
+void AS1130::setPwmSet24x5(uint8_t setIndex, const uint8_t *values)
+{
+  LRAS1130_OPERATION(SetPwmSet24x5);
+  uint8_t pwmData[cPwmDataSize];
+  // The 11th LED of each segment is not used in this layout.
+  std::memset(pwmData, 0, cPwmDataSize);
+  for (uint8_t y = 0; y < AS1130Picture24x5::getHeight(); ++y) {
+    for (uint8_t x = 0; x < AS1130Picture24x5::getWidth(); ++x) {
+      pwmData[getPwmDataIndex(getLedIndex24x5(x, y))] = *values;
+      ++values;
+    }
+  }
+  writePwmSet(setIndex, pwmData);
+}
+
+
+void AS1130::setBlinkSet(uint8_t setIndex, const uint8_t *blinkData)
+{
+  LRAS1130_OPERATION(SetBlinkSet);
   const uint8_t setAddress = (RS_BlinkAndPwmSet + setIndex);
-  const uint8_t address = 0x18 + ((ledIndex>>4)*11) + (ledIndex&0xf);
-  writeToMemory(setAddress, address, value);
+  writeToMemory(setAddress, 0x00, blinkData, cBlinkDataSize);
+}
+
+
+void AS1130::setBlinkSet(uint8_t setIndex, const AS1130Picture12x11 &picture)
+{
+  LRAS1130_OPERATION(SetBlinkSet);
+  uint8_t blinkData[cBlinkDataSize];
+  AS1130Picture12x11::writeRegisters(blinkData, picture.getData(), 0);
+  setBlinkSet(setIndex, blinkData);
+}
+
+
+void AS1130::setBlinkSet(uint8_t setIndex, const AS1130Picture24x5 &picture)
+{
+  LRAS1130_OPERATION(SetBlinkSet);
+  uint8_t blinkData[cBlinkDataSize];
+  AS1130Picture24x5::writeRegisters(blinkData, picture.getData(), 0);
+  setBlinkSet(setIndex, blinkData);
+}
+
+
+void AS1130::setGrayFrame(uint8_t frameIndex, const AS1130GrayPicture12x11 &picture, uint8_t pwmSetIndex)
+{
+  LRAS1130_OPERATION(SetGrayFrame);
+  uint8_t pwmData[cPwmDataSize];
+  picture.writePwmData(pwmData);
+  writePwmSet(pwmSetIndex, pwmData);
+  uint8_t registerData[AS1130FrameData::cSize];
+  picture.writeRegisters(registerData, pwmSetIndex);
+  writeFrame(frameIndex, registerData, false);
+}
+
+
+void AS1130::setGrayFrame(uint8_t frameIndex, const AS1130GrayPicture24x5 &picture, uint8_t pwmSetIndex)
+{
+  LRAS1130_OPERATION(SetGrayFrame);
+  uint8_t pwmData[cPwmDataSize];
+  picture.writePwmData(pwmData);
+  writePwmSet(pwmSetIndex, pwmData);
+  uint8_t registerData[AS1130FrameData::cSize];
+  picture.writeRegisters(registerData, pwmSetIndex);
+  writeFrame(frameIndex, registerData, false);
 }
 
 
@@ -205,8 +414,15 @@ uint8_t AS1130::getLedIndex12x11(uint8_t x, uint8_t y)
 }
 
 
+uint8_t AS1130::getPwmDataIndex(uint8_t ledIndex)
+{
+  return ((ledIndex>>4)*11) + (ledIndex&0xf);
+}
+
+
 void AS1130::setDotCorrection(const uint8_t *data)
 {
+  LRAS1130_OPERATION(SetDotCorrection);
   for (uint8_t i = 0; i < 12; ++i) {
     writeToMemory(RS_DotCorrection, i, data[i]);
   }
@@ -215,18 +431,21 @@ void AS1130::setDotCorrection(const uint8_t *data)
 
 void AS1130::setInterruptMask(uint8_t mask)
 {
+  LRAS1130_OPERATION(SetInterruptMask);
   writeControlRegister(CR_InterruptMask, mask);
 }
 
 
 void AS1130::setInterruptFrame(uint8_t lastFrame)
 {
+  LRAS1130_OPERATION(SetInterruptFrame);
   writeControlRegister(CR_InterruptFrameDefinition, lastFrame);
 }
 
 
 void AS1130::setInterfaceMonitoring(uint8_t timeout, bool enabled)
 {
+  LRAS1130_OPERATION(SetInterfaceMonitoring);
   uint8_t data = 0;
   if (enabled) {
     data = 1;
@@ -238,30 +457,35 @@ void AS1130::setInterfaceMonitoring(uint8_t timeout, bool enabled)
 
 void AS1130::setClockSynchronization(Synchronization synchronization, ClockFrequency clockFrequency)
 {
+  LRAS1130_OPERATION(SetClockSynchronization);
   writeControlRegister(CR_ClockSynchronization, synchronization|clockFrequency);
 }
 
 
 void AS1130::setCurrentSource(Current current)
 {
+  LRAS1130_OPERATION(SetCurrentSource);
   writeControlRegister(CR_CurrentSource, current);
 }
 
 
 void AS1130::setScanLimit(ScanLimit scanLimit)
 {
+  LRAS1130_OPERATION(SetScanLimit);
   writeControlRegisterBits(CR_DisplayOption, DOF_ScanLimitMask, scanLimit);
 }
 
 
 void AS1130::setBlinkEnabled(bool enabled)
 {
+  LRAS1130_OPERATION(SetBlinkEnabled);
   setOrClearControlRegisterBits(CR_MovieMode, MMF_BlinkEnabled, !enabled);
 }
 
 
 void AS1130::startPicture(uint8_t frameIndex, bool blinkAll)
 {
+  LRAS1130_OPERATION(StartPicture);
   uint8_t data = PF_DisplayPicture;
   data |= (frameIndex & PF_PictureAddressMask);
   if (blinkAll) {
@@ -273,24 +497,28 @@ void AS1130::startPicture(uint8_t frameIndex, bool blinkAll)
 
 void AS1130::stopPicture()
 {
+  LRAS1130_OPERATION(StopPicture);
   writeControlRegister(CR_Picture, 0x00);
 }
 
 
 void AS1130::setMovieEndFrame(MovieEndFrame movieEndFrame)
 {
+  LRAS1130_OPERATION(SetMovieEndFrame);
   setOrClearControlRegisterBits(CR_MovieMode, MMF_EndLast, movieEndFrame == MovieEndWithLastFrame);
 }
 
 
 void AS1130::setMovieFrameCount(uint8_t count)
 {
+  LRAS1130_OPERATION(SetMovieFrameCount);
   writeControlRegisterBits(CR_MovieMode, MMF_MovieFramesMask, count-1);
 }
 
 
 void AS1130::setFrameDelayMs(uint16_t delayMs)
 {
+  LRAS1130_OPERATION(SetFrameDelayMs);
   delayMs *= 10;
   delayMs /= 325;
   if (delayMs > 0x000f) {
@@ -302,42 +530,49 @@ void AS1130::setFrameDelayMs(uint16_t delayMs)
 
 void AS1130::setScrollingEnabled(bool enable)
 {
+  LRAS1130_OPERATION(SetScrollingEnabled);
   setOrClearControlRegisterBits(CR_FrameTimeScroll, FTSF_EnableScrolling, enable);
 }
 
 
 void AS1130::setScrollingBlockSize(ScrollingBlockSize scrollingBlockSize)
 {
+  LRAS1130_OPERATION(SetScrollingBlockSize);
   setOrClearControlRegisterBits(CR_FrameTimeScroll, FTSF_BlockSize, scrollingBlockSize == ScrollIn5LedBlocks);
 }
 
 
 void AS1130::setScrollingDirection(ScrollingDirection scrollingDirection)
 {
+  LRAS1130_OPERATION(SetScrollingDirection);
   setOrClearControlRegisterBits(CR_FrameTimeScroll, FTSF_ScrollDirection, scrollingDirection == ScrollingLeft);
 }
 
 
 void AS1130::setFrameFadingEnabled(bool enable)
 {
+  LRAS1130_OPERATION(SetFrameFadingEnabled);
   setOrClearControlRegisterBits(CR_FrameTimeScroll, FTSF_FrameFade, enable);
 }
 
 
 void AS1130::setBlinkFrequency(BlinkFrequency blinkFrequency)
 {
+  LRAS1130_OPERATION(SetBlinkFrequency);
   setOrClearControlRegisterBits(CR_DisplayOption, DOF_BlinkFrequency, blinkFrequency == BlinkFrequency3s);
 }
 
 
 void AS1130::setMovieLoopCount(MovieLoopCount movieLoopCount)
 {
+  LRAS1130_OPERATION(SetMovieLoopCount);
   writeControlRegisterBits(CR_DisplayOption, DOF_LoopsMask, movieLoopCount);
 }
 
 
 void AS1130::startMovie(uint8_t firstFrameIndex, bool blinkAll)
 {
+  LRAS1130_OPERATION(StartMovie);
   uint8_t data = MF_DisplayMovie;
   data |= (firstFrameIndex & MF_MovieAddressMask);
   if (blinkAll) {
@@ -349,70 +584,92 @@ void AS1130::startMovie(uint8_t firstFrameIndex, bool blinkAll)
 
 void AS1130::stopMovie()
 {
+  LRAS1130_OPERATION(StopMovie);
   writeControlRegister(CR_Movie, 0x00);
 }
 
 
 void AS1130::setLowVddResetEnabled(bool enabled)
 {
+  LRAS1130_OPERATION(SetLowVddResetEnabled);
   setOrClearControlRegisterBits(CR_Config, CF_LowVddReset, enabled);
 }
 
 
 void AS1130::setLowVddStatusEnabled(bool enabled)
 {
+  LRAS1130_OPERATION(SetLowVddStatusEnabled);
   setOrClearControlRegisterBits(CR_Config, CF_LowVddStatus, enabled);
 }
 
 
 void AS1130::setLedErrorCorrectionEnabled(bool enabled)
 {
+  LRAS1130_OPERATION(SetLedErrorCorrectionEnabled);
   setOrClearControlRegisterBits(CR_Config, CF_LedErrorCorrection, enabled);
 }
 
 
 void AS1130::setDotCorrectionEnabled(bool enabled)
 {
+  LRAS1130_OPERATION(SetDotCorrectionEnabled);
   setOrClearControlRegisterBits(CR_Config, CF_DotCorrection, enabled);
 }
 
 
 void AS1130::setTestAllLedsEnabled(bool enabled)
 {
+  LRAS1130_OPERATION(SetTestAllLedsEnabled);
   setOrClearControlRegisterBits(CR_ShutdownAndOpenShort, SOSF_TestAll, enabled);
 }
 
 
 void AS1130::setAutomaticTestEnabled(bool enabled)
 {
+  LRAS1130_OPERATION(SetAutomaticTestEnabled);
   setOrClearControlRegisterBits(CR_ShutdownAndOpenShort, SOSF_AutoTest, enabled);
 }
 
 
 void AS1130::startChip()
 {
+  LRAS1130_OPERATION(StartChip);
   setControlRegisterBits(CR_ShutdownAndOpenShort, SOSF_Shutdown);
 }
 
 
 void AS1130::stopChip()
 {
+  LRAS1130_OPERATION(StopChip);
   clearControlRegisterBits(CR_ShutdownAndOpenShort, SOSF_Shutdown);
 }
 
 
 void AS1130::resetChip()
 {
-  clearControlRegisterBits(CR_ShutdownAndOpenShort, SOSF_Initialize);
-  delay(100);
+  LRAS1130_OPERATION(ResetChip);
+  // The reset sets all bits of the register to zero, so there is no need to read it first.
+  if (writeControlRegister(CR_ShutdownAndOpenShort, 0x00) == AS1130Bus::StatusSuccess) {
+    // After the reset, all control registers have their power-on value of zero.
+    // Filling the cache avoids the reads for the following configuration.
+    std::memset(_controlRegisterCache, 0, cControlRegisterCacheSize);
+    _controlRegisterCacheValid = (_isControlRegisterCacheEnabled ? ((1<<cControlRegisterCacheSize)-1) : 0);
+  } else {
+    invalidateControlRegisterCache();
+  }
+  invalidateRegisterSelection();
+  invalidateFrameShadow();
+  invalidateStatusSnapshot();
+  _bus->delay(100);
 }
 
 
 void AS1130::runManualTest()
 {
+  LRAS1130_OPERATION(RunManualTest);
   setControlRegisterBits(CR_ShutdownAndOpenShort, SOSF_ManualTest);
   while (isLedTestRunning()) {
-    delay(10);
+    _bus->delay(10);
   }
   clearControlRegisterBits(CR_ShutdownAndOpenShort, SOSF_ManualTest);
 }
@@ -420,10 +677,8 @@ void AS1130::runManualTest()
 
 AS1130::LedStatus AS1130::getLedStatus(uint8_t ledIndex)
 {
-  if (ledIndex > 0xba) {
-    return LedStatusDisabled;
-  }
-  if ((ledIndex & 0x0f) > 0xa) {
+  LRAS1130_OPERATION(GetLedStatus);
+  if (!isLedIndexValid(ledIndex)) {
     return LedStatusDisabled;
   }
   const uint8_t ledBitMask = (1<<(ledIndex&0x7));
@@ -437,8 +692,99 @@ AS1130::LedStatus AS1130::getLedStatus(uint8_t ledIndex)
 }
 
 
+bool AS1130::readLedStatusMap(uint8_t *statusMap)
+{
+  LRAS1130_OPERATION(ReadLedStatusMap);
+  return readFromMemory(RS_Control, CR_OpenLedBase, statusMap, cLedStatusMapSize);
+}
+
+
+bool AS1130::readLedStatusMap(AS1130Picture12x11 &picture)
+{
+  LRAS1130_OPERATION(ReadLedStatusMap);
+  uint8_t statusMap[cLedStatusMapSize];
+  if (!readLedStatusMap(statusMap)) {
+    return false;
+  }
+  for (uint8_t x = 0; x < AS1130Picture12x11::getWidth(); ++x) {
+    for (uint8_t y = 0; y < AS1130Picture12x11::getHeight(); ++y) {
+      picture.setPixel(x, y, getLedStatus(statusMap, getLedIndex12x11(x, y)) == LedStatusOk);
+    }
+  }
+  return true;
+}
+
+
+bool AS1130::readLedStatusMap(AS1130Picture24x5 &picture)
+{
+  LRAS1130_OPERATION(ReadLedStatusMap);
+  uint8_t statusMap[cLedStatusMapSize];
+  if (!readLedStatusMap(statusMap)) {
+    return false;
+  }
+  for (uint8_t x = 0; x < AS1130Picture24x5::getWidth(); ++x) {
+    for (uint8_t y = 0; y < AS1130Picture24x5::getHeight(); ++y) {
+      picture.setPixel(x, y, getLedStatus(statusMap, getLedIndex24x5(x, y)) == LedStatusOk);
+    }
+  }
+  return true;
+}
+
+
+AS1130::LedStatus AS1130::getLedStatus(const uint8_t *statusMap, uint8_t ledIndex)
+{
+  if (!isLedIndexValid(ledIndex)) {
+    return LedStatusDisabled;
+  }
+  const uint8_t ledBitMask = (1<<(ledIndex&0x7));
+  if ((statusMap[ledIndex>>3] & ledBitMask) == 0) {
+    return LedStatusOpen;
+  } else {
+    return LedStatusOk;
+  }
+}
+
+
+bool AS1130::isLedIndexValid(uint8_t ledIndex)
+{
+  return ledIndex <= 0xba && (ledIndex & 0x0f) <= 0xa;
+}
+
+
+bool AS1130::readOnOffFrame(uint8_t frameIndex, AS1130FrameData &frameData)
+{
+  LRAS1130_OPERATION(ReadOnOffFrame);
+  const uint8_t frameAddress = (RS_OnOffFrame + frameIndex);
+  return readFromMemory(frameAddress, 0x00, frameData.registers, AS1130FrameData::cSize);
+}
+
+
+bool AS1130::readBlinkSet(uint8_t setIndex, uint8_t *blinkData)
+{
+  LRAS1130_OPERATION(ReadBlinkSet);
+  const uint8_t setAddress = (RS_BlinkAndPwmSet + setIndex);
+  return readFromMemory(setAddress, 0x00, blinkData, cBlinkDataSize);
+}
+
+
+bool AS1130::readPwmSet(uint8_t setIndex, uint8_t *pwmData)
+{
+  LRAS1130_OPERATION(ReadPwmSet);
+  const uint8_t setAddress = (RS_BlinkAndPwmSet + setIndex);
+  return readFromMemory(setAddress, cPwmDataAddress, pwmData, cPwmDataSize);
+}
+
+
+bool AS1130::readControlRegisters(uint8_t *registerData)
+{
+  LRAS1130_OPERATION(ReadControlRegisters);
+  return readFromMemory(RS_Control, CR_Picture, registerData, cControlRegisterCount);
+}
+
+
 bool AS1130::isLedTestRunning()
 {
+  LRAS1130_OPERATION(IsLedTestRunning);
   const uint8_t data = readControlRegister(CR_Status);
   return (data & SF_TestOn) != 0;
 }
@@ -446,6 +792,7 @@ bool AS1130::isLedTestRunning()
 
 bool AS1130::isMovieRunning()
 {
+  LRAS1130_OPERATION(IsMovieRunning);
   const uint8_t data = readControlRegister(CR_Status);
   return (data & SF_MovieOn) != 0;
 }
@@ -453,6 +800,7 @@ bool AS1130::isMovieRunning()
 
 uint8_t AS1130::getDisplayedFrame()
 {
+  LRAS1130_OPERATION(GetDisplayedFrame);
   const uint8_t data = readControlRegister(CR_Status);
   return (data>>2);
 }
@@ -460,124 +808,499 @@ uint8_t AS1130::getDisplayedFrame()
 
 uint8_t AS1130::getInterruptStatus()
 {
+  LRAS1130_OPERATION(GetInterruptStatus);
   return readControlRegister(CR_InterruptStatus);
 }
 
 
-void AS1130::writeToChip(uint8_t address, uint8_t data)
+bool AS1130::readStatusSnapshot(StatusSnapshot &snapshot)
 {
-  Wire.beginTransmission(_chipAddress); 
-  Wire.write(address); 
-  Wire.write(data); 
-  Wire.endTransmission(); 
+  LRAS1130_OPERATION(ReadStatusSnapshot);
+  uint8_t registerData[2];
+  if (!readFromMemory(RS_Control, CR_InterruptStatus, registerData, 2)) {
+    _isStatusSnapshotValid = false;
+    return false;
+  }
+  _statusSnapshot.interruptStatus = registerData[0];
+  _statusSnapshot.status = registerData[1];
+  _statusSnapshot.time = _bus->getMicroseconds();
+  _isStatusSnapshotValid = true;
+  snapshot = _statusSnapshot;
+  return true;
 }
 
 
-void AS1130::writeToMemory(uint8_t registerSelection, uint8_t address, uint8_t data)
+bool AS1130::getStatusSnapshot(StatusSnapshot &snapshot, uint32_t maximumAge)
 {
-  writeToChip(cRegisterSelectionAddress, registerSelection);
-  writeToChip(address, data);
+  LRAS1130_OPERATION(GetStatusSnapshot);
+  if (_isStatusSnapshotValid && (_bus->getMicroseconds() - _statusSnapshot.time) <= maximumAge) {
+    snapshot = _statusSnapshot;
+    return true;
+  }
+  return readStatusSnapshot(snapshot);
 }
 
 
-void AS1130::writeToMemory(uint8_t registerSelection, uint8_t address, const uint8_t *data, uint8_t size)
+void AS1130::invalidateStatusSnapshot()
 {
-  writeToChip(cRegisterSelectionAddress, registerSelection);
-  Wire.beginTransmission(_chipAddress);
-  Wire.write(address); 
-  for (uint8_t i = 0; i < size; ++i) {
-    Wire.write(data[i]);
-  }  
-  Wire.endTransmission();   
+  _isStatusSnapshotValid = false;
 }
 
 
-void AS1130::fillMemory(uint8_t registerSelection, uint8_t address, uint8_t value, uint8_t size)
+AS1130Bus::Status AS1130::writeToChip(uint8_t address, uint8_t data)
 {
-  writeToChip(cRegisterSelectionAddress, registerSelection);
-  while (size > 0) {
-    Wire.beginTransmission(_chipAddress);
-    if (Wire.write(address) == 0) {
-      // With failed address write, there is not much chance to do
-      // anything useful, so this just finishes the transmission
-      // and returns, leaving the error state set in the Wire
-      // library.
-      Wire.endTransmission();
+  AS1130Bus::Status status = AS1130Bus::StatusSuccess;
+  for (uint16_t attempt = 0; attempt <= _retryCount; ++attempt) {
+    _bus->beginTransmission(_chipAddress); 
+    _bus->write(address); 
+    _bus->write(data); 
+    status = endTransmission();
+    if (status == AS1130Bus::StatusSuccess) {
+      if (address == cRegisterSelectionAddress) {
+        _selectedRegister = data;
+      }
+      return status;
+    }
+  }
+  _lastError = status;
+  return status;
+}
+
+
+AS1130Bus::Status AS1130::selectRegister(uint8_t registerSelection)
+{
+  if (_selectedRegister != registerSelection) {
+    return writeToChip(cRegisterSelectionAddress, registerSelection);
+  }
+  return AS1130Bus::StatusSuccess;
+}
+
+
+void AS1130::invalidateRegisterSelection()
+{
+  _selectedRegister = cRegisterSelectionUnknown;
+}
+
+
+void AS1130::invalidateChipState()
+{
+  invalidateRegisterSelection();
+  invalidateControlRegisterCache();
+  invalidateFrameShadow();
+  invalidateStatusSnapshot();
+}
+
+
+AS1130Bus::Status AS1130::writeToMemory(uint8_t registerSelection, uint8_t address, uint8_t data)
+{
+  return writeBlockToMemory(registerSelection, address, &data, 1, false);
+}
+
+
+AS1130Bus::Status AS1130::writeToMemory(uint8_t registerSelection, uint8_t address, const uint8_t *data, uint8_t size)
+{
+  return writeBlockToMemory(registerSelection, address, data, size, false);
+}
+
+
+AS1130Bus::Status AS1130::writeBlockToMemory(uint8_t registerSelection, uint8_t address, const uint8_t *data, uint8_t size, bool isProgramMemory)
+{
+  // Split the data into chunks which fit into one transaction, together
+  // with the address byte. The chip increments the address automatically.
+  const uint8_t chunkSize = getTransactionSize() - 1;
+  uint8_t index = 0;
+  while (index < size) {
+    const uint8_t remaining = size - index;
+    const uint8_t count = (remaining < chunkSize ? remaining : chunkSize);
+    const AS1130Bus::Status status = writeChunk(registerSelection, address + index, data + index, 0, count, isProgramMemory);
+    if (status != AS1130Bus::StatusSuccess) {
+      return status;
+    }
+    index += count;
+  }
+  if (registerSelection == RS_Control) {
+    for (uint8_t i = 0; i < size; ++i) {
+      updateControlRegisterCache(address+i, readDataByte(data, i, isProgramMemory));
+    }
+  }
+  return AS1130Bus::StatusSuccess;
+}
+
+
+AS1130Bus::Status AS1130::writeChunk(uint8_t registerSelection, uint8_t address, const uint8_t *data, uint8_t value, uint8_t count, bool isProgramMemory)
+{
+  AS1130Bus::Status status = AS1130Bus::StatusSuccess;
+  if (static_cast<uint16_t>(count) + 1 > _bus->getBufferSize()) {
+    // The chunk does not fit into the buffer of the bus. Never send a truncated
+    // chunk, and sending it again will not help.
+    status = AS1130Bus::StatusDataTooLong;
+  }
+  for (uint16_t attempt = 0; attempt <= _retryCount && status != AS1130Bus::StatusDataTooLong; ++attempt) {
+    // Never send the data if the register bank could not be selected, it
+    // would overwrite the registers of the previously selected bank.
+    status = selectRegister(registerSelection);
+    if (status != AS1130Bus::StatusSuccess) {
+      break;
+    }
+    _bus->beginTransmission(_chipAddress);
+    bool isBufferFull = !_bus->write(address);
+    for (uint8_t i = 0; i < count && !isBufferFull; ++i) {
+      isBufferFull = !_bus->write(data != nullptr ? readDataByte(data, i, isProgramMemory) : value);
+    }
+    if (isBufferFull) {
+      // The bus reported a larger buffer than it has. The transmission is
+      // abandoned without ending it, so the truncated chunk is not sent.
+      status = AS1130Bus::StatusDataTooLong;
+      break;
+    }
+    status = endTransmission();
+    if (status == AS1130Bus::StatusSuccess) {
+      return status;
+    }
+  }
+  _lastError = status;
+  if (registerSelection == RS_Control) {
+    // The values of the control registers are unknown after a failed write.
+    invalidateControlRegisterCache();
+  }
+  return status;
+}
+
+
+void AS1130::writeFrame(uint8_t frameIndex, const uint8_t *registerData, bool isProgramMemory)
+{
+  const uint8_t frameAddress = (RS_OnOffFrame + frameIndex);
+  if (frameIndex >= _frameShadowCount) {
+    writeBlockToMemory(frameAddress, 0x00, registerData, AS1130FrameData::cSize, isProgramMemory);
+    return;
+  }
+  uint8_t *shadow = _frameShadow + (frameIndex * AS1130FrameData::cSize);
+  const uint8_t validMask = (1<<(frameIndex&7));
+  uint8_t &validFlags = _frameShadowValid[frameIndex>>3];
+  uint8_t firstIndex = 0;
+  uint8_t lastIndex = AS1130FrameData::cSize - 1;
+  if ((validFlags & validMask) != 0) {
+    // Only send the range of bytes which changed since the last write.
+    while (firstIndex < AS1130FrameData::cSize && shadow[firstIndex] == readDataByte(registerData, firstIndex, isProgramMemory)) {
+      ++firstIndex;
+    }
+    if (firstIndex == AS1130FrameData::cSize) {
       return;
     }
+    while (shadow[lastIndex] == readDataByte(registerData, lastIndex, isProgramMemory)) {
+      --lastIndex;
+    }
+  }
+  const uint8_t size = lastIndex - firstIndex + 1;
+  if (writeBlockToMemory(frameAddress, firstIndex, registerData + firstIndex, size, isProgramMemory) == AS1130Bus::StatusSuccess) {
+    for (uint8_t i = firstIndex; i <= lastIndex; ++i) {
+      shadow[i] = readDataByte(registerData, i, isProgramMemory);
+    }
+    validFlags |= validMask;
+  } else {
+    validFlags &= ~validMask;
+  }
+}
 
-    // Send as much bytes as possible in one loop, by default the
-    // Arduino Wire library has a 32 byte buffer, so we can send
-    // a maximum of 31 data bytes at once (in addition to the
-    // address byte).
-    while (size > 0) {
-      if (Wire.write(value) == 0) {
-        Wire.clearWriteError();
-        break;
-      }
-      size--;
-      address++;
+
+AS1130Bus::Status AS1130::fillMemory(uint8_t registerSelection, uint8_t address, uint8_t value, uint8_t size)
+{
+  // Send as much bytes as possible in one transaction, by default the
+  // Arduino Wire library has a 32 byte buffer, so we can send
+  // a maximum of 31 data bytes at once (in addition to the
+  // address byte).
+  const uint8_t chunkSize = getTransactionSize() - 1;
+  uint8_t index = 0;
+  while (index < size) {
+    const uint8_t remaining = size - index;
+    const uint8_t count = (remaining < chunkSize ? remaining : chunkSize);
+    const AS1130Bus::Status status = writeChunk(registerSelection, address + index, nullptr, value, count, false);
+    if (status != AS1130Bus::StatusSuccess) {
+      return status;
+    }
+    index += count;
+  }
+  if (registerSelection == RS_Control) {
+    for (uint8_t i = 0; i < size; ++i) {
+      updateControlRegisterCache(address+i, value);
+    }
+  }
+  return AS1130Bus::StatusSuccess;
+}
+
+
+bool AS1130::readFromMemory(uint8_t registerSelection, uint8_t address, uint8_t *buffer, uint8_t size)
+{
+  const uint8_t chunkSize = getTransactionSize();
+  while (size > 0) {
+    // Read as much bytes as fit into the receive buffer of the bus and
+    // set the address again for each chunk.
+    const uint8_t count = (size < chunkSize ? size : chunkSize);
+    if (!readChunk(registerSelection, address, buffer, count)) {
+      return false;
     }
-    Wire.endTransmission();
+    buffer += count;
+    address += count;
+    size -= count;
   }
+  return true;
 }
 
 
 uint8_t AS1130::readFromMemory(uint8_t registerSelection, uint8_t address)
 {
-  writeToChip(cRegisterSelectionAddress, registerSelection);
-  Wire.beginTransmission(_chipAddress);
-  Wire.write(address);
-  Wire.endTransmission();
-  Wire.requestFrom(_chipAddress, 1);
-  if (Wire.available() == 1) {
-    const uint8_t data = Wire.read();
+  uint8_t data;
+  if (readChunk(registerSelection, address, &data, 1)) {
     return data;
-  } else {
-    return 0x00;
   }
+  return 0x00;
+}
+
+
+bool AS1130::readChunk(uint8_t registerSelection, uint8_t address, uint8_t *buffer, uint8_t count)
+{
+  AS1130Bus::Status status = AS1130Bus::StatusSuccess;
+  for (uint16_t attempt = 0; attempt <= _retryCount; ++attempt) {
+    status = selectRegister(registerSelection);
+    if (status != AS1130Bus::StatusSuccess) {
+      break;
+    }
+    _bus->beginTransmission(_chipAddress);
+    _bus->write(address);
+    status = endTransmission();
+    if (status != AS1130Bus::StatusSuccess) {
+      continue;
+    }
+    if (_bus->requestFrom(_chipAddress, count) == count) {
+      for (uint8_t i = 0; i < count; ++i) {
+        buffer[i] = _bus->read();
+      }
+      return true;
+    }
+    // The chip did not send all bytes.
+    invalidateRegisterSelection();
+    status = AS1130Bus::StatusError;
+  }
+  _lastError = status;
+  return false;
+}
+
+
+AS1130Bus::Status AS1130::endTransmission()
+{
+  const AS1130Bus::Status status = _bus->endTransmission();
+  if (status != AS1130Bus::StatusSuccess) {
+    // After a bus error, we can not be sure which register bank is selected.
+    invalidateRegisterSelection();
+  }
+  return status;
 }
 
 
-void AS1130::writeControlRegister(ControlRegister controlRegister, uint8_t data)
+AS1130Bus::Status AS1130::writeControlRegister(ControlRegister controlRegister, uint8_t data)
 {
-  writeToMemory(RS_Control, controlRegister, data);
+  return writeToMemory(RS_Control, controlRegister, data);
 }
 
 
 uint8_t AS1130::readControlRegister(ControlRegister controlRegister)
 {
-  return readFromMemory(RS_Control, controlRegister);
+  uint8_t data = 0x00;
+  readControlRegister(controlRegister, data);
+  return data;
+}
+
+
+bool AS1130::readControlRegister(ControlRegister controlRegister, uint8_t &data)
+{
+  if (_isControlRegisterCacheEnabled && controlRegister < cControlRegisterCacheSize) {
+    const uint16_t validMask = (1<<controlRegister);
+    if (_controlRegisterCacheValid == 0) {
+      // On the first miss, read all cached registers with one burst read.
+      synchronizeControlRegisterCache();
+    }
+    if ((_controlRegisterCacheValid & validMask) == 0) {
+      if (!readChunk(RS_Control, controlRegister, &_controlRegisterCache[controlRegister], 1)) {
+        return false;
+      }
+      _controlRegisterCacheValid |= validMask;
+    }
+    data = _controlRegisterCache[controlRegister];
+    return true;
+  }
+  return readChunk(RS_Control, controlRegister, &data, 1);
 }
 
 
-void AS1130::writeControlRegisterBits(ControlRegister controlRegister, uint8_t mask, uint8_t data)
+AS1130Bus::Status AS1130::writeControlRegisterBits(ControlRegister controlRegister, uint8_t mask, uint8_t data)
 {
-  uint8_t registerData = readControlRegister(controlRegister);
+  uint8_t registerData;
+  if (!readControlRegister(controlRegister, registerData)) {
+    // Writing the register without knowing the other bits would change them.
+    return _lastError;
+  }
   registerData &= (~mask);
   registerData |= (data & mask);
-  writeControlRegister(controlRegister, registerData);
+  return writeControlRegister(controlRegister, registerData);
 }
 
 
-void AS1130::setControlRegisterBits(ControlRegister controlRegister, uint8_t mask)
+AS1130Bus::Status AS1130::setControlRegisterBits(ControlRegister controlRegister, uint8_t mask)
 {
-  writeControlRegisterBits(controlRegister, mask, mask);
+  return writeControlRegisterBits(controlRegister, mask, mask);
 }
 
 
-void AS1130::clearControlRegisterBits(ControlRegister controlRegister, uint8_t mask)
+AS1130Bus::Status AS1130::clearControlRegisterBits(ControlRegister controlRegister, uint8_t mask)
 {
-  writeControlRegisterBits(controlRegister, mask, 0);
+  return writeControlRegisterBits(controlRegister, mask, 0);
 }
 
 
-void AS1130::setOrClearControlRegisterBits(ControlRegister controlRegister, uint8_t mask, bool setBits)
+AS1130Bus::Status AS1130::setOrClearControlRegisterBits(ControlRegister controlRegister, uint8_t mask, bool setBits)
 {
   if (setBits) {
-    writeControlRegisterBits(controlRegister, mask, mask);
+    return writeControlRegisterBits(controlRegister, mask, mask);
+  } else {
+    return writeControlRegisterBits(controlRegister, mask, 0);
+  }
+}
+
+
+void AS1130::setControlRegisterCacheEnabled(bool enabled)
+{
+  _isControlRegisterCacheEnabled = enabled;
+  invalidateControlRegisterCache();
+}
+
+
+void AS1130::invalidateControlRegisterCache()
+{
+  _controlRegisterCacheValid = 0;
+}
+
+
+void AS1130::synchronizeControlRegisterCache()
+{
+  LRAS1130_OPERATION(SynchronizeControlRegisterCache);
+  if (!_isControlRegisterCacheEnabled) {
+    return;
+  }
+  if (readFromMemory(RS_Control, CR_Picture, _controlRegisterCache, cControlRegisterCacheSize)) {
+    _controlRegisterCacheValid = ((1<<cControlRegisterCacheSize)-1);
+  } else {
+    _controlRegisterCacheValid = 0;
+  }
+}
+
+
+void AS1130::setMaximumTransactionSize(uint8_t size)
+{
+  _maximumTransactionSize = size;
+}
+
+
+void AS1130::setRetryCount(uint8_t count)
+{
+  _retryCount = count;
+}
+
+
+void AS1130::clearLastError()
+{
+  _lastError = AS1130Bus::StatusSuccess;
+}
+
+
+uint8_t AS1130::getTransactionSize() const
+{
+  const uint8_t bufferSize = _bus->getBufferSize();
+  if (_maximumTransactionSize >= 2 && _maximumTransactionSize < bufferSize) {
+    return _maximumTransactionSize;
+  }
+  if (bufferSize < 2) {
+    // A transaction needs at least the address and one data byte. With a
+    // smaller buffer, the writes fail instead of never finishing.
+    return 2;
+  }
+  return bufferSize;
+}
+
+
+void AS1130::setFrameShadow(uint8_t *buffer, uint8_t frameCount)
+{
+  if (frameCount > cFrameShadowMaximumCount) {
+    frameCount = cFrameShadowMaximumCount;
+  }
+  _frameShadow = buffer;
+  _frameShadowCount = (buffer != nullptr ? frameCount : 0);
+  invalidateFrameShadow();
+}
+
+
+void AS1130::invalidateFrameShadow()
+{
+  std::memset(_frameShadowValid, 0, sizeof(_frameShadowValid));
+}
+
+
+void AS1130::setGammaTable_P(const AS1130GammaTable *gammaTable)
+{
+  _gammaTable = gammaTable;
+}
+
+
+void AS1130::setPwmDotCorrection(const uint8_t *data)
+{
+  if (data != nullptr) {
+    std::memcpy(_pwmDotCorrection, data, sizeof(_pwmDotCorrection));
+    _isPwmDotCorrectionEnabled = true;
   } else {
-    writeControlRegisterBits(controlRegister, mask, 0);
+    _isPwmDotCorrectionEnabled = false;
+  }
+}
+
+
+uint8_t AS1130::getCorrectedPwmValue(uint8_t ledIndex, uint8_t value) const
+{
+  if (_gammaTable != nullptr) {
+    value = readDataByte(_gammaTable->values, value, true);
+  }
+  if (_isPwmDotCorrectionEnabled) {
+    const uint16_t factor = _pwmDotCorrection[ledIndex>>4] + 1;
+    value = static_cast<uint8_t>((value * factor) >> 8);
+  }
+  return value;
+}
+
+
+void AS1130::correctPwmData(uint8_t *pwmData) const
+{
+  for (uint8_t segment = 0; segment < 12; ++segment) {
+    const uint8_t ledIndex = (segment<<4);
+    for (uint8_t led = 0; led < 11; ++led) {
+      *pwmData = getCorrectedPwmValue(ledIndex, *pwmData);
+      ++pwmData;
+    }
+  }
+}
+
+
+void AS1130::writePwmSet(uint8_t setIndex, uint8_t *pwmData)
+{
+  if (isPwmCorrectionEnabled()) {
+    correctPwmData(pwmData);
+  }
+  const uint8_t setAddress = (RS_BlinkAndPwmSet + setIndex);
+  writeToMemory(setAddress, cPwmDataAddress, pwmData, cPwmDataSize);
+}
+
+
+void AS1130::updateControlRegisterCache(uint8_t address, uint8_t data)
+{
+  if (_isControlRegisterCacheEnabled && address < cControlRegisterCacheSize) {
+    _controlRegisterCache[address] = data;
+    _controlRegisterCacheValid |= (1<<address);
   }
 }
 
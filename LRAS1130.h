@@ -19,10 +19,18 @@
 #pragma once
 
 
+#include "LRAS1130Bus.h"
+#include "LRAS1130FrameData.h"
+#include "LRAS1130GammaTable.h"
+#include "LRAS1130GrayPicture12x11.h"
+#include "LRAS1130GrayPicture24x5.h"
+#include "LRAS1130Instrumentation.h"
 #include "LRAS1130Picture12x11.h"
 #include "LRAS1130Picture24x5.h"
 
-#include <Wire.h>
+#ifdef ARDUINO
+#include "LRAS1130WireBus.h"
+#endif
 
 #ifdef ARDUINO_ARCH_AVR
 #include <inttypes.h>
@@ -302,14 +310,84 @@ public:
     SF_FrameOnMask  = 0b11111100,
   };
 
+  /// @brief The number of control registers kept in the register cache.
+  ///
+  /// This are the registers from CR_Picture to CR_ClockSynchronization. The status
+  /// registers are changed by the chip and are never cached.
+  ///
+  static const uint8_t cControlRegisterCacheSize = CR_ClockSynchronization + 1;
+
+  /// @brief The maximum number of frames in the frame shadow.
+  ///
+  static const uint8_t cFrameShadowMaximumCount = 36;
+
+  /// @brief The number of blink bytes in a blink&PWM set.
+  ///
+  static const uint8_t cBlinkDataSize = 0x18;
+
+  /// @brief The address of the first PWM value in a blink&PWM set.
+  ///
+  static const uint8_t cPwmDataAddress = 0x18;
+
+  /// @brief The number of PWM values in a blink&PWM set.
+  ///
+  /// There is one value for each of the 12 segments with 11 LEDs. The value for
+  /// a LED index is at position `((ledIndex>>4)*11) + (ledIndex&0xf)`.
+  ///
+  static const uint8_t cPwmDataSize = 132;
+
+  /// @brief The number of registers read with readControlRegisters().
+  ///
+  /// This are all registers from CR_Picture to CR_Status.
+  ///
+  static const uint8_t cControlRegisterCount = CR_Status + 1;
+
+  /// @brief The number of bytes in a LED status map.
+  ///
+  static const uint8_t cLedStatusMapSize = 0x18;
+
   /// @}
 
 public:
+  /// @brief A snapshot of the interrupt status and status registers.
+  ///
+  /// Both registers are read with one burst read. See readStatusSnapshot().
+  ///
+  struct StatusSnapshot {
+    uint8_t interruptStatus; ///< The interrupt status register, see InterruptMaskFlag.
+    uint8_t status; ///< The status register, see StatusFlag.
+    uint32_t time; ///< The time when the snapshot was read, in microseconds.
+
+    /// @brief Check if a LED test was running.
+    ///
+    inline bool isLedTestRunning() const { return (status & SF_TestOn) != 0; }
+
+    /// @brief Check if a movie was running.
+    ///
+    inline bool isMovieRunning() const { return (status & SF_MovieOn) != 0; }
+
+    /// @brief Get the displayed frame.
+    ///
+    inline uint8_t getDisplayedFrame() const { return (status >> 2); }
+  };
+
+public:
+#ifdef ARDUINO
   /// @brief Create a new driver instance
   ///
+  /// The driver uses the global `Wire` object for the communication.
+  ///
   /// @param chipAddress The address of the chip.
   ///
   AS1130(ChipAddress chipAddress = ChipAddress0);
+#endif
+
+  /// @brief Create a new driver instance using the given bus.
+  ///
+  /// @param bus The bus used for the communication with the chip.
+  /// @param chipAddress The address of the chip.
+  ///
+  AS1130(AS1130Bus &bus, ChipAddress chipAddress = ChipAddress0);
 
 public: // High-level functions.
   /// @brief Check the chip communication.
@@ -405,6 +483,26 @@ public: // High-level functions.
   ///
   void setOnOffFrame12x11(uint8_t frameIndex, const uint8_t *data, uint8_t pwmSetIndex = 0);
 
+  /// @brief Set-up a on/off frame with precomputed register data.
+  ///
+  /// The register data is written to the chip without any conversion. Use the
+  /// functions of AS1130FrameData to convert pictures at compile time.
+  ///
+  /// @param frameIndex The index of the frame. This has to be a value between 0 and 35.
+  /// @param frameData The register data for the frame, including the PWM set index.
+  ///
+  void setOnOffFrameRaw(uint8_t frameIndex, const AS1130FrameData &frameData);
+
+  /// @brief Set-up a on/off frame with precomputed register data from flash memory.
+  ///
+  /// On AVR platforms, the register data is read from program memory (`PROGMEM`).
+  /// On all other platforms this function is equal to setOnOffFrameRaw().
+  ///
+  /// @param frameIndex The index of the frame. This has to be a value between 0 and 35.
+  /// @param frameData Pointer to the register data in program memory.
+  ///
+  void setOnOffFrameRaw_P(uint8_t frameIndex, const AS1130FrameData *frameData);
+
   /// @brief Set-up a on/off frame with all LEDs disabled.
   ///
   /// @param frameIndex The index of the frame. This has to be a value between 0 and 35.
@@ -439,6 +537,77 @@ public: // High-level functions.
   ///
   void setPwmValue(uint8_t setIndex, uint8_t ledIndex, uint8_t value);
 
+  /// @brief Set all PWM values of a blink&PWM set.
+  ///
+  /// All values are written using as few transactions as possible.
+  ///
+  /// @param setIndex The set index has to be a value between 0 and 5.
+  /// @param pwmData An array with cPwmDataSize (132) values in the order of the chip,
+  ///   11 values for each segment. See getPwmDataIndex().
+  ///
+  void setPwmSet(uint8_t setIndex, const uint8_t *pwmData);
+
+  /// @brief Set all PWM values of a blink&PWM set for a 12x11 LED matrix.
+  ///
+  /// @param setIndex The set index has to be a value between 0 and 5.
+  /// @param values An array with 132 PWM values, row by row. The value for a LED
+  ///   is at position `y*12+x`.
+  ///
+  void setPwmSet12x11(uint8_t setIndex, const uint8_t *values);
+
+  /// @brief Set all PWM values of a blink&PWM set for a 24x5 LED matrix.
+  ///
+  /// @param setIndex The set index has to be a value between 0 and 5.
+  /// @param values An array with 120 PWM values, row by row. The value for a LED
+  ///   is at position `y*24+x`.
+  ///
+  void setPwmSet24x5(uint8_t setIndex, const uint8_t *values);
+
+  /// @brief Set the blink bits of a blink&PWM set.
+  ///
+  /// @param setIndex The set index has to be a value between 0 and 5.
+  /// @param blinkData An array with cBlinkDataSize (24) bytes in the register layout
+  ///   of the on/off frames.
+  ///
+  void setBlinkSet(uint8_t setIndex, const uint8_t *blinkData);
+
+  /// @brief Set the blink bits of a blink&PWM set from a picture.
+  ///
+  /// @param setIndex The set index has to be a value between 0 and 5.
+  /// @param picture The picture where each set pixel marks a blinking LED.
+  ///
+  void setBlinkSet(uint8_t setIndex, const AS1130Picture12x11 &picture);
+
+  /// @brief Set the blink bits of a blink&PWM set from a picture.
+  ///
+  /// @param setIndex The set index has to be a value between 0 and 5.
+  /// @param picture The picture where each set pixel marks a blinking LED.
+  ///
+  void setBlinkSet(uint8_t setIndex, const AS1130Picture24x5 &picture);
+
+  /// @brief Display a grayscale picture using an on/off frame and a blink&PWM set.
+  ///
+  /// All LEDs with an intensity greater than zero are enabled in the on/off frame,
+  /// the intensities are written into the PWM values of the given set. The frame
+  /// and the PWM values are written using burst writes. The blink bits of the set
+  /// are not changed.
+  ///
+  /// @param frameIndex The index of the frame. This has to be a value between 0 and 35.
+  /// @param picture The grayscale picture to write.
+  /// @param pwmSetIndex The blink&PWM set to use for the frame, a value between 0 and 5.
+  ///
+  void setGrayFrame(uint8_t frameIndex, const AS1130GrayPicture12x11 &picture, uint8_t pwmSetIndex = 0);
+
+  /// @brief Display a grayscale picture using an on/off frame and a blink&PWM set.
+  ///
+  /// @see setGrayFrame(uint8_t, const AS1130GrayPicture12x11&, uint8_t)
+  ///
+  /// @param frameIndex The index of the frame. This has to be a value between 0 and 35.
+  /// @param picture The grayscale picture to write.
+  /// @param pwmSetIndex The blink&PWM set to use for the frame, a value between 0 and 5.
+  ///
+  void setGrayFrame(uint8_t frameIndex, const AS1130GrayPicture24x5 &picture, uint8_t pwmSetIndex = 0);
+
   /// @brief Get the LED index for a coordinate in a 24x5 LED setup.
   ///
   /// @warning There is no range check done for the coordinates. Values outside
@@ -448,7 +617,7 @@ public: // High-level functions.
   /// @param y The Y coordinate from 0 to 4.
   /// @return The LED index.
   ///
-  uint8_t getLedIndex24x5(uint8_t x, uint8_t y);
+  static uint8_t getLedIndex24x5(uint8_t x, uint8_t y);
 
   /// @brief Get the LED index for a coordinate in a 12x11 LED setup.
   ///
@@ -459,7 +628,14 @@ public: // High-level functions.
   /// @param y The Y coordinate from 0 to 10.
   /// @return The LED index.
   ///
-  uint8_t getLedIndex12x11(uint8_t x, uint8_t y);
+  static uint8_t getLedIndex12x11(uint8_t x, uint8_t y);
+
+  /// @brief Get the position of a LED in the PWM data of a blink&PWM set.
+  ///
+  /// @param ledIndex The index of the LED. A value between 0x00 and 0xba.
+  /// @return The index in the PWM data, a value between 0 and 131.
+  ///
+  static uint8_t getPwmDataIndex(uint8_t ledIndex);
 
   /// @brief Set the dot correction data.
   ///
@@ -656,7 +832,8 @@ public: // High-level functions.
 
   /// @brief Reset the chip.
   ///
-  /// This will reset the chip using the initialize flag.
+  /// This will reset the chip using the initialize flag. If the control register
+  /// cache is enabled, it is filled with the power-on values of the registers.
   ///
   void resetChip();
 
@@ -685,6 +862,90 @@ public: // High-level functions.
   ///
   LedStatus getLedStatus(uint8_t ledIndex);
 
+  /// @brief Read the status of all LEDs.
+  ///
+  /// This reads all open LED registers from the chip in one transaction.
+  /// Each bit in the map represents one LED index, LED index 0x00 is the
+  /// lowest bit in the first byte. A set bit marks a working LED. Use
+  /// getLedStatus(const uint8_t*, uint8_t) to get the status of a LED from the map.
+  ///
+  /// You have to start a test, before this function will return valid values.
+  ///
+  /// @param statusMap A buffer with cLedStatusMapSize (24) bytes for the status map.
+  /// @return `true` on success, `false` if there was a bus error.
+  ///
+  bool readLedStatusMap(uint8_t *statusMap);
+
+  /// @brief Read the status of all LEDs into a picture.
+  ///
+  /// The status of all LEDs is read in one transaction. Each pixel of a working LED is set
+  /// in the picture, each pixel of an open LED is cleared.
+  ///
+  /// @param picture The picture which receives the status.
+  /// @return `true` on success, `false` if there was a bus error.
+  ///
+  bool readLedStatusMap(AS1130Picture12x11 &picture);
+
+  /// @brief Read the status of all LEDs into a picture.
+  ///
+  /// The status of all LEDs is read in one transaction. Each pixel of a working LED is set
+  /// in the picture, each pixel of an open LED is cleared.
+  ///
+  /// @param picture The picture which receives the status.
+  /// @return `true` on success, `false` if there was a bus error.
+  ///
+  bool readLedStatusMap(AS1130Picture24x5 &picture);
+
+  /// @brief Get the status of a LED from a status map.
+  ///
+  /// @param statusMap The status map read with readLedStatusMap().
+  /// @param ledIndex The index of the LED. A value between 0x00 and 0xba.
+  /// @return The status for the given LED index.
+  ///
+  static LedStatus getLedStatus(const uint8_t *statusMap, uint8_t ledIndex);
+
+  /// @brief Check if a LED index is valid.
+  ///
+  /// @param ledIndex The LED index to check.
+  /// @return `true` if the index addresses a LED, `false` for the unused indexes.
+  ///
+  static bool isLedIndexValid(uint8_t ledIndex);
+
+  /// @brief Read the register data of a on/off frame back from the chip.
+  ///
+  /// @param frameIndex The index of the frame. This has to be a value between 0 and 35.
+  /// @param frameData The frame data which receives the registers.
+  /// @return `true` on success, `false` if there was a bus error.
+  ///
+  bool readOnOffFrame(uint8_t frameIndex, AS1130FrameData &frameData);
+
+  /// @brief Read the blink bits of a blink&PWM set back from the chip.
+  ///
+  /// @param setIndex The set index has to be a value between 0 and 5.
+  /// @param blinkData A buffer with cBlinkDataSize (24) bytes. The bits have the same
+  ///   layout as the on/off frame registers.
+  /// @return `true` on success, `false` if there was a bus error.
+  ///
+  bool readBlinkSet(uint8_t setIndex, uint8_t *blinkData);
+
+  /// @brief Read the PWM values of a blink&PWM set back from the chip.
+  ///
+  /// @param setIndex The set index has to be a value between 0 and 5.
+  /// @param pwmData A buffer with cPwmDataSize (132) bytes.
+  /// @return `true` on success, `false` if there was a bus error.
+  ///
+  bool readPwmSet(uint8_t setIndex, uint8_t *pwmData);
+
+  /// @brief Read a snapshot of all control and status registers.
+  ///
+  /// Reading the registers this way will also read (and clear) the interrupt status.
+  ///
+  /// @param registerData A buffer with cControlRegisterCount (16) bytes. Use the
+  ///   values from ControlRegister as index into this buffer.
+  /// @return `true` on success, `false` if there was a bus error.
+  ///
+  bool readControlRegisters(uint8_t *registerData);
+
   /// @brief Check if a LED test is running.
   ///
   /// @return `true` if a LED test is running, `false` if no test is running.
@@ -709,6 +970,38 @@ public: // High-level functions.
   ///
   uint8_t getInterruptStatus();
 
+  /// @brief Read the interrupt status and status register.
+  ///
+  /// Both registers are read with one burst read. This replaces separate calls of
+  /// isLedTestRunning(), isMovieRunning(), getDisplayedFrame() and getInterruptStatus().
+  ///
+  /// @note Reading the interrupt status register clears the interrupt flags on the chip.
+  ///
+  /// @param snapshot The snapshot which receives the values.
+  /// @return `true` on success, `false` if there was a bus error.
+  ///
+  bool readStatusSnapshot(StatusSnapshot &snapshot);
+
+  /// @brief Get a status snapshot which is not older than the given age.
+  ///
+  /// If the last snapshot read by this function or readStatusSnapshot() is not
+  /// older than `maximumAge`, it is returned without accessing the bus. Otherwise
+  /// a new snapshot is read. Use this in tight loops to limit the bus traffic.
+  ///
+  /// @note A returned cached snapshot repeats the interrupt flags of the last read.
+  ///
+  /// @param snapshot The snapshot which receives the values.
+  /// @param maximumAge The maximum age of the snapshot in microseconds.
+  /// @return `true` on success, `false` if there was a bus error.
+  ///
+  bool getStatusSnapshot(StatusSnapshot &snapshot, uint32_t maximumAge);
+
+  /// @brief Discard the cached status snapshot.
+  ///
+  /// The next call of getStatusSnapshot() reads a new snapshot.
+  ///
+  void invalidateStatusSnapshot();
+
 public:
   /// @name Low-Level Functions.
   /// Functions used for low-level operations.
@@ -716,27 +1009,65 @@ public:
 
   /// @brief Write a two byte sequence to the chip.
   ///
+  /// If the transaction fails, it is sent again, see setRetryCount().
+  ///
   /// @param address The address byte.
   /// @param data The data byte.
+  /// @return The status of the last attempt.
+  ///
+  AS1130Bus::Status writeToChip(uint8_t address, uint8_t data);
+
+  /// @brief Select a register bank.
+  ///
+  /// The selected register bank is tracked and the selection is only sent to the
+  /// chip if it differs from the last selection.
   ///
-  void writeToChip(uint8_t address, uint8_t data);
+  /// @param registerSelection The register selection address.
+  /// @return The status of the selection.
+  ///
+  AS1130Bus::Status selectRegister(uint8_t registerSelection);
+
+  /// @brief Forget the currently selected register bank.
+  ///
+  /// The next memory access will send the register selection to the chip again.
+  /// This is done automatically after a reset and after a bus error. Call this function
+  /// if the chip was reset by other means.
+  ///
+  void invalidateRegisterSelection();
+
+  /// @brief Forget everything known about the state of the chip.
+  ///
+  /// This invalidates the register selection, the control register cache,
+  /// the frame shadow and the status snapshot. The next accesses read the
+  /// control registers again and send all frames completely. Call this
+  /// function if writes may have been lost, e.g. if a deferred write of an
+  /// AS1130TransactionQueue failed.
+  ///
+  void invalidateChipState();
 
   /// @brief Write a byte to a given memory location.
   ///
   /// @param registerSelection The register selection address.
   /// @param address The address of the register.
   /// @param data The data byte to write to the selected register.
+  /// @return The status of the write.
   ///
-  void writeToMemory(uint8_t registerSelection, uint8_t address, uint8_t data);
+  AS1130Bus::Status writeToMemory(uint8_t registerSelection, uint8_t address, uint8_t data);
 
   /// @brief Write a block of data to a given memory location.
   ///
+  /// The data is written in chunks which fit into one transaction. See
+  /// setMaximumTransactionSize() for details. If a chunk fails, only this
+  /// chunk is sent again, see setRetryCount(). If it still fails, the
+  /// following chunks are not sent.
+  ///
   /// @param registerSelection The register selection address.
   /// @param startAddress The address of the register.
   /// @param data A pointer to the start of the data to write.
   /// @param size The number of bytes to write.
+  /// @return The status of the write.
   ///
-  void writeToMemory(uint8_t registerSelection, uint8_t address, const uint8_t *data, uint8_t size);
+  AS1130Bus::Status writeToMemory(uint8_t registerSelection, uint8_t address, const uint8_t *data, uint8_t size);
 
   /// @brief Fill a memory location block with a single byte/
   ///
@@ -744,28 +1075,42 @@ public:
   /// @param startAddress The address of the register.
   /// @param value The value to write.
   /// @param size The number of bytes to write.
+  /// @return The status of the write.
   ///
-  void fillMemory(uint8_t registerSelection, uint8_t address, uint8_t value, uint8_t size);
+  AS1130Bus::Status fillMemory(uint8_t registerSelection, uint8_t address, uint8_t value, uint8_t size);
 
   /// @brief Read a byte from a given memory location.
   ///
   /// @param registerSelection The register selection address.
   /// @param address The address of the register.
-  /// @return The read byte.
+  /// @return The read byte, or zero if there was a bus error.
   ///
   uint8_t readFromMemory(uint8_t registerSelection, uint8_t address);  
 
+  /// @brief Read a block of data from a given memory location.
+  ///
+  /// The data is read in chunks which fit into the buffer of the bus.
+  ///
+  /// @param registerSelection The register selection address.
+  /// @param address The address of the first register.
+  /// @param buffer The buffer which receives the data.
+  /// @param size The number of bytes to read.
+  /// @return `true` on success, `false` if there was a bus error.
+  ///
+  bool readFromMemory(uint8_t registerSelection, uint8_t address, uint8_t *buffer, uint8_t size);
+
   /// @brief Write a byte to a control register.
   ///
   /// @param controlRegister The control register.
   /// @param data The data byte to write to the control register.
+  /// @return The status of the write.
   ///
-  void writeControlRegister(ControlRegister controlRegister, uint8_t data);
+  AS1130Bus::Status writeControlRegister(ControlRegister controlRegister, uint8_t data);
 
   /// @brief Read a byte from a control register.
   ///
   /// @param controlRegister The control register to read a byte from.
-  /// @return The read byte.
+  /// @return The read byte, or zero if there was a bus error.
   ///
   uint8_t readControlRegister(ControlRegister controlRegister);
 
@@ -774,35 +1119,336 @@ public:
   /// @param controlRegister The control register to change.
   /// @param mask The mask for the bits. Only the bits set in this mask are changed.
   /// @param data The bits to set. The data is masked with the mask.
+  /// @return The status of the write. If the register can not be read,
+  ///   nothing is written.
   ///
-  void writeControlRegisterBits(ControlRegister controlRegister, uint8_t mask, uint8_t data);
+  AS1130Bus::Status writeControlRegisterBits(ControlRegister controlRegister, uint8_t mask, uint8_t data);
 
   /// @brief Set selected bits in a control register.
   ///
   /// @param controlRegister The control register to change.
   /// @param mask The mask for the bits to set.
+  /// @return The status of the write.
   ///
-  void setControlRegisterBits(ControlRegister controlRegister, uint8_t mask);
+  AS1130Bus::Status setControlRegisterBits(ControlRegister controlRegister, uint8_t mask);
 
   /// @brief Clear selected bits in a control register.
   ///
   /// @param controlRegister The control register to change.
   /// @param mask The mask for the bits to clear.
+  /// @return The status of the write.
   ///  
-  void clearControlRegisterBits(ControlRegister controlRegister, uint8_t mask);
+  AS1130Bus::Status clearControlRegisterBits(ControlRegister controlRegister, uint8_t mask);
 
   /// @brief Set or clear selected bits in a control register.
   ///
   /// @param controlRegister The control register to change.
   /// @param mask The mask for the bits to clear.
   /// @param setBits True to set the bits, false to clear the bits.
+  /// @return The status of the write.
   ///  
-  void setOrClearControlRegisterBits(ControlRegister controlRegister, uint8_t mask, bool setBits);
+  AS1130Bus::Status setOrClearControlRegisterBits(ControlRegister controlRegister, uint8_t mask, bool setBits);
+
+  /// @brief Limit the size of a single transaction.
+  ///
+  /// All block writes and reads are split into transactions which fit into the
+  /// buffer of the bus. Use this function to limit the size of a transaction
+  /// further, e.g. to keep the bus free for other devices.
+  ///
+  /// @param size The maximum number of bytes in one transaction, including the
+  ///   register address. Zero to use the buffer size of the bus.
+  ///
+  void setMaximumTransactionSize(uint8_t size);
+
+  /// @brief Get the number of bytes used for one transaction.
+  ///
+  /// @return The smaller value of the buffer size of the bus and the maximum
+  ///   transaction size, including the register address. The result is at
+  ///   least 2, the address and one data byte.
+  ///
+  uint8_t getTransactionSize() const;
+
+  /// @brief Set how often a failed transaction is sent again.
+  ///
+  /// On a noisy bus, a single transaction can fail. With retries, only the
+  /// failed transaction is sent again, after selecting the register bank
+  /// again. If a block write still fails, the rest of the block is not
+  /// sent and the frame shadow for this frame is invalidated, so the next
+  /// write of the frame sends it completely. Check getLastError() to detect
+  /// these failures and repeat the call which failed.
+  ///
+  /// @param count The maximum number of retries for each transaction.
+  ///   Zero, the default, to send each transaction only once.
+  ///
+  void setRetryCount(uint8_t count);
+
+  /// @brief Get the status of the last failed transaction.
+  ///
+  /// Transactions which succeed after a retry are not counted as failed.
+  ///
+  /// @return The status of the last transaction which failed after all
+  ///   retries, or `StatusSuccess` if no transaction failed since the last
+  ///   call of clearLastError().
+  ///
+  inline AS1130Bus::Status getLastError() const { return _lastError; }
+
+  /// @brief Reset the status returned by getLastError().
+  ///
+  void clearLastError();
+
+  /// @}
+
+public:
+  /// @name Control Register Cache.
+  /// Functions to control the in-memory copy of the control registers.
+  /// @{
+
+  /// @brief Enable or disable the control register cache.
+  ///
+  /// If the cache is enabled, the library keeps a copy of all written control
+  /// registers in memory. Functions which change only some bits of a control
+  /// register will use this copy, instead of reading the register from the chip
+  /// first. This saves one read cycle for each of these calls.
+  ///
+  /// If the cache is empty, the first read fills it with one burst read of all
+  /// cached registers. Written registers are stored in the cache as well, and
+  /// synchronizeControlRegisterCache() reads all registers again. After
+  /// resetChip(), the cache is filled with the power-on values of the chip.
+  /// If the chip is reset in any other way (e.g. by a low VDD reset), you have
+  /// to call invalidateControlRegisterCache() or synchronizeControlRegisterCache().
+  ///
+  /// The cache is disabled by default.
+  ///
+  /// @param enabled True to enable the cache, false to disable it.
+  ///
+  void setControlRegisterCacheEnabled(bool enabled);
+
+  /// @brief Mark all cached control registers as invalid.
+  ///
+  /// The next access to a control register will read the value from the chip.
+  ///
+  void invalidateControlRegisterCache();
+
+  /// @brief Read all cached control registers from the chip.
+  ///
+  /// This will resynchronize the cache with the actual values from the chip.
+  /// If the cache is disabled, this function does nothing.
+  ///
+  void synchronizeControlRegisterCache();
+
+  /// @}
+
+public:
+  /// @name Frame Shadow.
+  /// Functions to control the in-memory copy of the on/off frames.
+  /// @{
+
+  /// @brief Set a buffer for the frame shadow.
+  ///
+  /// If a frame shadow is set, the library keeps a copy of the register data
+  /// of the first frames written to the chip. If one of this frames is
+  /// written again, only the range of changed bytes is sent to the chip.
+  /// If just one pixel changes, this reduces the written data from 25 to
+  /// 2 bytes.
+  ///
+  /// The frame shadow is invalidated by resetChip(). If the chip is reset in
+  /// any other way, call invalidateFrameShadow().
+  ///
+  /// Example for a shadow of the first two frames:
+  /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  /// uint8_t frameShadow[2*AS1130FrameData::cSize];
+  /// ledDriver.setFrameShadow(frameShadow, 2);
+  /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  ///
+  /// @param buffer A buffer with 24 bytes for each frame, or `nullptr` to
+  ///   disable the frame shadow.
+  /// @param frameCount The number of frames, starting with the first frame,
+  ///   which are tracked in the frame shadow. A value between 0 and 36.
+  ///
+  void setFrameShadow(uint8_t *buffer, uint8_t frameCount);
+
+  /// @brief Mark all frames in the frame shadow as invalid.
+  ///
+  /// The next write of each frame will send all bytes to the chip.
+  ///
+  void invalidateFrameShadow();
 
   /// @}
 
+public:
+  /// @name PWM Correction.
+  /// Functions to correct all PWM values before they are sent to the chip.
+  /// @{
+
+  /// @brief Set a gamma table for all PWM values.
+  ///
+  /// If a gamma table is set, each PWM value passed to setPwmValue(), setPwmSet(),
+  /// setPwmSet12x11(), setPwmSet24x5(), setBlinkAndPwmSetAll() and setGrayFrame()
+  /// is translated using this table, before it is sent to the chip. This allows
+  /// perceptually linear fades with one table lookup per LED.
+  ///
+  /// On AVR platforms, the table has to be placed in program memory (`PROGMEM`).
+  /// The table is not copied, it has to exist as long it is used.
+  ///
+  /// Example:
+  /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  /// ledDriver.setGammaTable_P(&AS1130GammaTable::cGamma22);
+  /// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  ///
+  /// @param gammaTable The gamma table to use, or `nullptr` to disable the gamma correction.
+  ///
+  void setGammaTable_P(const AS1130GammaTable *gammaTable);
+
+  /// @brief Set a correction factor for the PWM values of each segment.
+  ///
+  /// This works like setDotCorrection(), but the correction is applied to the PWM
+  /// values by the library, after the gamma correction. Each PWM value is scaled using
+  /// `(value*(factor+1))>>8`, so a factor of 0xff keeps the value unchanged.
+  /// It can be combined with the dot correction of the chip.
+  ///
+  /// @param data Pointer to an array with 12 bytes, one factor for each segment.
+  ///   The data is copied. Pass `nullptr` to disable the correction.
+  ///
+  void setPwmDotCorrection(const uint8_t *data);
+
+  /// @brief Get the corrected PWM value for a LED.
+  ///
+  /// This applies the gamma table and the PWM dot correction to the value.
+  ///
+  /// @param ledIndex The index of the LED. A value between 0x00 and 0xba.
+  /// @param value The PWM value to correct.
+  /// @return The PWM value as it is sent to the chip.
+  ///
+  uint8_t getCorrectedPwmValue(uint8_t ledIndex, uint8_t value) const;
+
+  /// @}
+
+#ifdef LRAS1130_INSTRUMENTATION
+public:
+  /// @name Instrumentation.
+  /// Only available if `LRAS1130_INSTRUMENTATION` is defined.
+  /// @{
+
+  /// @brief Set the instrumentation which counts the transactions of each function.
+  ///
+  /// The instrumentation has to be the bus of this instance, or one of
+  /// the buses which forward the calls to the chip. Without it, all
+  /// transactions are counted as AS1130Instrumentation::OperationOther.
+  ///
+  /// @param instrumentation The instrumentation, or `nullptr` to stop marking the transactions.
+  ///
+  inline void setInstrumentation(AS1130Instrumentation *instrumentation) { _instrumentation = instrumentation; }
+
+  /// @}
+#endif
+
 private:
+  /// @brief Check if any PWM correction is enabled.
+  ///
+  inline bool isPwmCorrectionEnabled() const {
+    return _gammaTable != nullptr || _isPwmDotCorrectionEnabled;
+  }
+
+  /// @brief Apply the PWM correction to a complete set of PWM values.
+  ///
+  /// @param pwmData The cPwmDataSize (132) PWM values in the order of the chip.
+  ///
+  void correctPwmData(uint8_t *pwmData) const;
+
+  /// @brief Write a set of PWM values, after applying the PWM correction.
+  ///
+  /// @param setIndex The set index has to be a value between 0 and 5.
+  /// @param pwmData The cPwmDataSize (132) PWM values in the order of the chip.
+  ///   The values are modified by this call.
+  ///
+  void writePwmSet(uint8_t setIndex, uint8_t *pwmData);
+
+  /// @brief Write the register data for a on/off frame.
+  ///
+  /// If the frame is tracked in the frame shadow, only changed bytes are written.
+  ///
+  /// @param frameIndex The index of the frame.
+  /// @param registerData The 24 bytes with the register data.
+  /// @param isProgramMemory True if the data is stored in program memory.
+  ///
+  void writeFrame(uint8_t frameIndex, const uint8_t *registerData, bool isProgramMemory);
+
+  /// @brief Update the cached value of a control register.
+  ///
+  /// @param address The address of the control register.
+  /// @param data The new value of the register.
+  ///
+  void updateControlRegisterCache(uint8_t address, uint8_t data);
+
+  /// @brief Write a block of data from RAM or program memory to a given memory location.
+  ///
+  /// @param registerSelection The register selection address.
+  /// @param address The address of the register.
+  /// @param data A pointer to the start of the data to write.
+  /// @param size The number of bytes to write.
+  /// @param isProgramMemory True if the data is stored in program memory.
+  /// @return The status of the write.
+  ///
+  AS1130Bus::Status writeBlockToMemory(uint8_t registerSelection, uint8_t address, const uint8_t *data, uint8_t size, bool isProgramMemory);
+
+  /// @brief Write one transaction to the memory, with retries.
+  ///
+  /// @param registerSelection The register selection address.
+  /// @param address The address of the first register.
+  /// @param data A pointer to the data, or `nullptr` to write `value` into all registers.
+  /// @param value The value to write if `data` is `nullptr`.
+  /// @param count The number of bytes, has to fit into one transaction.
+  /// @param isProgramMemory True if the data is stored in program memory.
+  /// @return The status of the last attempt, or StatusDataTooLong without
+  ///   sending anything if the address and data do not fit into the buffer of the bus.
+  ///
+  AS1130Bus::Status writeChunk(uint8_t registerSelection, uint8_t address, const uint8_t *data, uint8_t value, uint8_t count, bool isProgramMemory);
+
+  /// @brief Read one transaction from the memory, with retries.
+  ///
+  /// @param registerSelection The register selection address.
+  /// @param address The address of the first register.
+  /// @param buffer The buffer which receives the data.
+  /// @param count The number of bytes, has to fit into the buffer of the bus.
+  /// @return `true` on success, `false` if there was a bus error.
+  ///
+  bool readChunk(uint8_t registerSelection, uint8_t address, uint8_t *buffer, uint8_t count);
+
+  /// @brief Read a byte from a control register or the cache.
+  ///
+  /// @param controlRegister The control register to read.
+  /// @param data The variable which receives the value.
+  /// @return `true` on success, `false` if there was a bus error.
+  ///
+  bool readControlRegister(ControlRegister controlRegister, uint8_t &data);
+
+  /// @brief End a transmission and check the result.
+  ///
+  /// @return The status of the transmission.
+  ///
+  AS1130Bus::Status endTransmission();
+
+private:
+  AS1130Bus *_bus; ///< The bus used for the communication.
   uint8_t _chipAddress; ///< The selected address of the chip.
+  uint8_t _selectedRegister; ///< The currently selected register bank.
+  bool _isControlRegisterCacheEnabled; ///< If the control register cache is enabled.
+  uint16_t _controlRegisterCacheValid; ///< One bit for each cached register with a valid value.
+  uint8_t _controlRegisterCache[cControlRegisterCacheSize]; ///< The cached control register values.
+  uint8_t _maximumTransactionSize; ///< The maximum transaction size or zero.
+  uint8_t *_frameShadow; ///< The buffer for the frame shadow or `nullptr`.
+  uint8_t _frameShadowCount; ///< The number of frames in the frame shadow.
+  uint8_t _frameShadowValid[(cFrameShadowMaximumCount+7)/8]; ///< One bit for each frame with valid shadow data.
+  const AS1130GammaTable *_gammaTable; ///< The gamma table in program memory or `nullptr`.
+  bool _isPwmDotCorrectionEnabled; ///< If the PWM dot correction is enabled.
+  uint8_t _pwmDotCorrection[12]; ///< The PWM correction factor for each segment.
+  bool _isStatusSnapshotValid; ///< If the cached status snapshot is valid.
+  StatusSnapshot _statusSnapshot; ///< The last read status snapshot.
+  uint8_t _retryCount; ///< The maximum number of retries for each transaction.
+  AS1130Bus::Status _lastError; ///< The status of the last failed transaction.
+#ifdef LRAS1130_INSTRUMENTATION
+  AS1130Instrumentation *_instrumentation; ///< The instrumentation or `nullptr`.
+#endif
 };
 
 }
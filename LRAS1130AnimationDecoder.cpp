@@ -0,0 +1,148 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#include "LRAS1130AnimationDecoder.h"
+
+
+#ifdef ARDUINO_ARCH_AVR
+#include <avr/pgmspace.h>
+// Make it compatible with the standart
+#include <string.h>
+namespace std { using ::memset; using ::memcpy; }
+#else
+#include <cstring>
+#endif
+
+
+namespace lr {
+
+
+AS1130AnimationDecoder::AS1130AnimationDecoder()
+  : _data(nullptr),
+    _position(nullptr),
+    _frameCount(0),
+    _frameIndex(0),
+    _isProgramMemory(false),
+    _isInvalid(false)
+{
+}
+
+
+bool AS1130AnimationDecoder::begin(const uint8_t *data)
+{
+  return begin(data, false);
+}
+
+
+bool AS1130AnimationDecoder::begin_P(const uint8_t *data)
+{
+  return begin(data, true);
+}
+
+
+bool AS1130AnimationDecoder::begin(const uint8_t *data, bool isProgramMemory)
+{
+  _data = data;
+  _isProgramMemory = isProgramMemory;
+  _position = data;
+  _frameCount = 0;
+  _frameIndex = 0;
+  _isInvalid = false;
+  if (readByte() != cFormatVersion) {
+    return false;
+  }
+  _frameCount = readByte();
+  _frameCount |= (static_cast<uint16_t>(readByte()) << 8);
+  return true;
+}
+
+
+void AS1130AnimationDecoder::rewind()
+{
+  _position = _data + cHeaderSize;
+  _frameIndex = 0;
+  _isInvalid = false;
+}
+
+
+bool AS1130AnimationDecoder::decodeNextFrame(AS1130FrameData &frameData)
+{
+  if (!hasNextFrame()) {
+    return false;
+  }
+  // Decode into a copy, so invalid data never leaves a partially decoded frame.
+  AS1130FrameData decodedFrame;
+  if (_frameIndex == 0) {
+    std::memset(decodedFrame.registers, 0, AS1130FrameData::cSize);
+  } else {
+    std::memcpy(decodedFrame.registers, frameData.registers, AS1130FrameData::cSize);
+  }
+  uint8_t index = 0;
+  while (index < AS1130FrameData::cSize) {
+    const uint8_t token = readByte();
+    const uint8_t length = (token & cTokenLengthMask) + 1;
+    if (length > AS1130FrameData::cSize - index) {
+      // Invalid data, stop the animation.
+      _isInvalid = true;
+      return false;
+    }
+    if ((token & cTokenSkip) != 0) {
+      index += length;
+    } else {
+      for (uint8_t i = 0; i < length; ++i) {
+        decodedFrame.registers[index] ^= readByte();
+        ++index;
+      }
+    }
+  }
+  std::memcpy(frameData.registers, decodedFrame.registers, AS1130FrameData::cSize);
+  ++_frameIndex;
+  return true;
+}
+
+
+bool AS1130AnimationDecoder::streamSource(void *context, uint32_t frameNumber, AS1130FrameData &frameData)
+{
+  AS1130AnimationDecoder *decoder = static_cast<AS1130AnimationDecoder*>(context);
+  if (frameNumber == 0) {
+    decoder->rewind();
+  }
+  return decoder->decodeNextFrame(frameData);
+}
+
+
+uint8_t AS1130AnimationDecoder::readByte()
+{
+  uint8_t result;
+#ifdef ARDUINO_ARCH_AVR
+  if (_isProgramMemory) {
+    result = pgm_read_byte(_position);
+  } else {
+    result = *_position;
+  }
+#else
+  result = *_position;
+#endif
+  ++_position;
+  return result;
+}
+
+
+}
+
+
@@ -0,0 +1,176 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#pragma once
+
+
+#include "LRAS1130.h"
+
+
+namespace lr {
+
+
+/// @brief A decoder for compressed animations.
+///
+/// The animation data is a sequence of on/off frame register images. Each frame
+/// is stored as the XOR delta to the previous frame, compressed with a simple
+/// run-length encoding. Use the `AnimationEncoder` tool from the `extras/tools`
+/// directory to create the data from text files.
+///
+/// The data starts with a header of three bytes:
+/// - The format version cFormatVersion.
+/// - The number of frames as 16 bit little endian value.
+///
+/// Each frame is encoded as a sequence of tokens, which cover exactly the
+/// 24 register bytes of the frame:
+/// - `0b1nnnnnnn`: Skip `n+1` bytes, they are equal to the previous frame.
+/// - `0b0nnnnnnn`: Followed by `n+1` bytes, which are XORed with the previous frame.
+///
+/// The first frame is encoded as delta to a frame with all bytes set to zero.
+///
+/// The decoder does not allocate any memory. It decodes each frame in place into
+/// a frame data buffer, which has to contain the previous decoded frame.
+///
+/// Example:
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// AS1130AnimationDecoder decoder;
+/// AS1130FrameData frame;
+/// decoder.begin_P(animationData);
+/// while (decoder.decodeNextFrame(frame)) {
+///   ledDriver.setOnOffFrameRaw(0, frame);
+///   ...
+/// }
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+class AS1130AnimationDecoder
+{
+public:
+  /// @brief The version of the data format.
+  ///
+  static const uint8_t cFormatVersion = 1;
+
+  /// @brief The size of the header in bytes.
+  ///
+  static const uint8_t cHeaderSize = 3;
+
+  /// @brief The flag for a token which skips unchanged bytes.
+  ///
+  static const uint8_t cTokenSkip = 0x80;
+
+  /// @brief The mask for the length of a token.
+  ///
+  static const uint8_t cTokenLengthMask = 0x7f;
+
+public:
+  /// @brief Create a decoder without data.
+  ///
+  AS1130AnimationDecoder();
+
+public:
+  /// @brief Start decoding animation data in RAM.
+  ///
+  /// @param data The animation data. The data is not copied.
+  /// @return `true` on success, `false` if the data has the wrong format.
+  ///
+  bool begin(const uint8_t *data);
+
+  /// @brief Start decoding animation data in program memory.
+  ///
+  /// On AVR platforms, the data is read from program memory (`PROGMEM`).
+  /// On all other platforms this function is equal to begin().
+  ///
+  /// @param data The animation data. The data is not copied.
+  /// @return `true` on success, `false` if the data has the wrong format.
+  ///
+  bool begin_P(const uint8_t *data);
+
+  /// @brief Restart decoding with the first frame.
+  ///
+  /// This also clears the invalid data flag, so the frames before an invalid
+  /// frame can be played again.
+  ///
+  void rewind();
+
+  /// @brief Get the number of frames in the animation.
+  ///
+  inline uint16_t getFrameCount() const { return _frameCount; }
+
+  /// @brief Get the index of the next decoded frame.
+  ///
+  inline uint16_t getFrameIndex() const { return _frameIndex; }
+
+  /// @brief Check if there are more frames to decode.
+  ///
+  /// @return `true` if there are more frames, `false` at the end of the animation
+  ///   or after invalid data was found.
+  ///
+  inline bool hasNextFrame() const { return !_isInvalid && _frameIndex < _frameCount; }
+
+  /// @brief Check if invalid data was found while decoding.
+  ///
+  inline bool isDataInvalid() const { return _isInvalid; }
+
+  /// @brief Decode the next frame.
+  ///
+  /// The frame data has to contain the previous frame returned by this decoder.
+  /// For the first frame, the frame data is cleared by this function.
+  ///
+  /// If the tokens of the frame are invalid, the frame data is not changed,
+  /// isDataInvalid() returns `true` and no more frames are decoded until the
+  /// decoder is rewound. The frame count of the header is kept.
+  ///
+  /// @param frameData The frame data to update.
+  /// @return `true` if a frame was decoded, `false` at the end of the animation
+  ///   or if the data is invalid.
+  ///
+  bool decodeNextFrame(AS1130FrameData &frameData);
+
+  /// @brief A frame source for the AS1130StreamPlayer.
+  ///
+  /// Pass a pointer to the decoder as context. The decoder is rewound
+  /// if the player requests the first frame.
+  ///
+  /// @param context A pointer to the decoder.
+  /// @param frameNumber The number of the requested frame.
+  /// @param frameData The frame data with the previous frame.
+  /// @return `true` if a frame was decoded, `false` at the end of the animation.
+  ///
+  static bool streamSource(void *context, uint32_t frameNumber, AS1130FrameData &frameData);
+
+private:
+  /// @brief Read the next byte from the data.
+  ///
+  uint8_t readByte();
+
+  /// @brief Start decoding the given data.
+  ///
+  bool begin(const uint8_t *data, bool isProgramMemory);
+
+private:
+  const uint8_t *_data; ///< The start of the animation data.
+  const uint8_t *_position; ///< The current read position.
+  uint16_t _frameCount; ///< The number of frames.
+  uint16_t _frameIndex; ///< The index of the next frame.
+  bool _isProgramMemory; ///< If the data is stored in program memory.
+  bool _isInvalid; ///< If invalid data was found while decoding.
+};
+
+
+}
+
+
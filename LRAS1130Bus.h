@@ -0,0 +1,119 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#pragma once
+
+
+#ifdef ARDUINO_ARCH_AVR
+#include <inttypes.h>
+#else
+#include <cinttypes>
+#endif
+
+
+namespace lr {
+
+
+/// @brief The interface for the I2C bus used to communicate with the chip.
+///
+/// The AS1130 class uses this interface for all communication with the chip.
+/// The interface closely follows the transmission model of the Arduino Wire
+/// library. Use the AS1130WireBus class for the Wire library, or implement
+/// this interface to use a different I2C peripheral.
+///
+class AS1130Bus
+{
+public:
+  /// @brief The status of a transmission.
+  ///
+  /// The values match the return values of `Wire.endTransmission()`.
+  ///
+  enum Status : uint8_t {
+    StatusSuccess = 0, ///< The transmission was successful.
+    StatusDataTooLong = 1, ///< The data did not fit into the transmit buffer.
+    StatusAddressNack = 2, ///< The chip did not acknowledge its address.
+    StatusDataNack = 3, ///< The chip did not acknowledge a data byte.
+    StatusError = 4 ///< Any other bus error.
+  };
+
+public:
+  /// @brief Start a new write transmission.
+  ///
+  /// @param chipAddress The I2C address of the chip.
+  ///
+  virtual void beginTransmission(uint8_t chipAddress) = 0;
+
+  /// @brief Add a byte to the current transmission.
+  ///
+  /// @param data The byte to add.
+  /// @return `true` if the byte was added, `false` if the transmit buffer is full.
+  ///
+  virtual bool write(uint8_t data) = 0;
+
+  /// @brief Send the current transmission to the chip.
+  ///
+  /// @return The status of the transmission.
+  ///
+  virtual Status endTransmission() = 0;
+
+  /// @brief Request bytes from the chip.
+  ///
+  /// @param chipAddress The I2C address of the chip.
+  /// @param count The number of bytes to request.
+  /// @return The number of bytes received.
+  ///
+  virtual uint8_t requestFrom(uint8_t chipAddress, uint8_t count) = 0;
+
+  /// @brief Read the next received byte.
+  ///
+  /// @return The next byte received with requestFrom().
+  ///
+  virtual uint8_t read() = 0;
+
+  /// @brief Get the maximum number of bytes in one transmission.
+  ///
+  /// @return The size of the transmit buffer in bytes, including the register address.
+  ///
+  virtual uint8_t getBufferSize() const = 0;
+
+  /// @brief Wait for the given time.
+  ///
+  /// This is used while waiting for the chip, e.g. after a reset.
+  ///
+  /// @param milliseconds The time to wait in milliseconds.
+  ///
+  virtual void delay(uint16_t milliseconds) = 0;
+
+  /// @brief Get the current time.
+  ///
+  /// This is used to measure the age of cached values. The value may
+  /// overflow, only the difference between two values is used.
+  ///
+  /// @return The current time in microseconds.
+  ///
+  virtual uint32_t getMicroseconds() const = 0;
+
+protected:
+  /// @brief Protected destructor, bus objects are never deleted using this interface.
+  ///
+  ~AS1130Bus() {}
+};
+
+
+}
+
@@ -0,0 +1,141 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#include "LRAS1130ChipGroup.h"
+
+
+namespace lr {
+
+
+AS1130ChipGroup::AS1130ChipGroup(AS1130Bus &bus)
+  : _bus(&bus),
+    _chipCount(0),
+    _activeChips(0xffff),
+    _lastError(StatusSuccess),
+    _transmissionSize(0),
+    _chip(*this)
+{
+  _chip.setControlRegisterCacheEnabled(true);
+}
+
+
+bool AS1130ChipGroup::addChip(AS1130::ChipAddress chipAddress)
+{
+  if (_chipCount >= cMaximumChipCount) {
+    return false;
+  }
+  _chipAddresses[_chipCount] = chipAddress;
+  ++_chipCount;
+  return true;
+}
+
+
+void AS1130ChipGroup::setActiveChips(uint16_t mask)
+{
+  _activeChips = mask;
+  // The chips outside of the previous mask may have a different register
+  // selection, frame content and configuration, so nothing known about
+  // the previous chips is valid for the new set.
+  _chip.invalidateRegisterSelection();
+  _chip.invalidateFrameShadow();
+  _chip.invalidateControlRegisterCache();
+  _chip.invalidateStatusSnapshot();
+}
+
+
+void AS1130ChipGroup::beginTransmission(uint8_t chipAddress)
+{
+  // The address is ignored, the transmission is sent to all chips.
+  (void)chipAddress;
+  _transmissionSize = 0;
+}
+
+
+bool AS1130ChipGroup::write(uint8_t data)
+{
+  if (_transmissionSize >= getBufferSize()) {
+    return false;
+  }
+  _transmission[_transmissionSize] = data;
+  ++_transmissionSize;
+  return true;
+}
+
+
+AS1130Bus::Status AS1130ChipGroup::endTransmission()
+{
+  Status result = StatusSuccess;
+  for (uint8_t i = 0; i < _chipCount; ++i) {
+    if ((_activeChips & (1U<<i)) == 0) {
+      continue;
+    }
+    _bus->beginTransmission(_chipAddresses[i]);
+    for (uint8_t j = 0; j < _transmissionSize; ++j) {
+      _bus->write(_transmission[j]);
+    }
+    const Status status = _bus->endTransmission();
+    if (status != StatusSuccess) {
+      result = status;
+      _lastError = status;
+    }
+  }
+  return result;
+}
+
+
+uint8_t AS1130ChipGroup::requestFrom(uint8_t chipAddress, uint8_t count)
+{
+  // All active chips have the same configuration, so only the first active chip is read.
+  (void)chipAddress;
+  for (uint8_t i = 0; i < _chipCount; ++i) {
+    if ((_activeChips & (1U<<i)) != 0) {
+      return _bus->requestFrom(_chipAddresses[i], count);
+    }
+  }
+  return 0;
+}
+
+
+uint8_t AS1130ChipGroup::read()
+{
+  return _bus->read();
+}
+
+
+uint8_t AS1130ChipGroup::getBufferSize() const
+{
+  const uint8_t busBufferSize = _bus->getBufferSize();
+  return busBufferSize < cMaximumTransmissionSize ? busBufferSize : cMaximumTransmissionSize;
+}
+
+
+void AS1130ChipGroup::delay(uint16_t milliseconds)
+{
+  _bus->delay(milliseconds);
+}
+
+
+uint32_t AS1130ChipGroup::getMicroseconds() const
+{
+  return _bus->getMicroseconds();
+}
+
+
+}
+
+
@@ -0,0 +1,127 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#pragma once
+
+
+#include "LRAS1130.h"
+
+
+namespace lr {
+
+
+/// @brief A group of chips which receive identical writes.
+///
+/// The group is a bus which forwards every write transmission to all chips
+/// in the group. Use the AS1130 instance returned by getChip() to configure
+/// all chips at once: each register value is calculated once and the same
+/// write sequence is sent to every chip. Frames and PWM sets are converted
+/// once and sent to all chips as well.
+///
+/// The control register cache of the group chip is enabled, so functions
+/// which change single bits of a register do not read the register. If a
+/// register has to be read, it is read from the first active chip of the group only.
+///
+/// Example:
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// AS1130ChipGroup group(AS1130WireBus::getDefault());
+/// group.addChip(AS1130::ChipAddress0);
+/// group.addChip(AS1130::ChipAddress1);
+/// AS1130 &allChips = group.getChip();
+/// allChips.resetChip();
+/// allChips.setRamConfiguration(AS1130::RamConfiguration1);
+/// allChips.setOnOffFrame24x5(0, frameData);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+class AS1130ChipGroup : public AS1130Bus
+{
+public:
+  /// @brief The maximum number of chips in a group.
+  ///
+  static const uint8_t cMaximumChipCount = 16;
+
+  /// @brief The maximum number of bytes in one transmission.
+  ///
+  static const uint8_t cMaximumTransmissionSize = 32;
+
+public:
+  /// @brief Create a new empty group.
+  ///
+  /// @param bus The bus where all chips of the group are connected.
+  ///
+  AS1130ChipGroup(AS1130Bus &bus);
+
+public:
+  /// @brief Add a chip to the group.
+  ///
+  /// @param chipAddress The address of the chip.
+  /// @return `true` if the chip was added, `false` if the group is full.
+  ///
+  bool addChip(AS1130::ChipAddress chipAddress);
+
+  /// @brief Get the number of chips in the group.
+  ///
+  inline uint8_t getChipCount() const { return _chipCount; }
+
+  /// @brief Select the chips which receive the writes.
+  ///
+  /// By default, all chips of the group receive the writes. Use this function
+  /// to send a frame only to some of the chips. Reads are done from the
+  /// first active chip. Changing the mask invalidates the register selection,
+  /// the frame shadow and the caches of the chip instance.
+  ///
+  /// @param mask One bit for each chip, in the order the chips were added.
+  ///
+  void setActiveChips(uint16_t mask);
+
+  /// @brief Get the chip instance which writes to all chips.
+  ///
+  inline AS1130& getChip() { return _chip; }
+
+  /// @brief Get the status of the last failed transmission.
+  ///
+  /// @return The status of the last transmission which failed on any chip,
+  ///   or StatusSuccess if all transmissions succeeded.
+  ///
+  inline Status getLastError() const { return _lastError; }
+
+public: // Implement AS1130Bus
+  virtual void beginTransmission(uint8_t chipAddress) override;
+  virtual bool write(uint8_t data) override;
+  virtual Status endTransmission() override;
+  virtual uint8_t requestFrom(uint8_t chipAddress, uint8_t count) override;
+  virtual uint8_t read() override;
+  virtual uint8_t getBufferSize() const override;
+  virtual void delay(uint16_t milliseconds) override;
+  virtual uint32_t getMicroseconds() const override;
+
+private:
+  AS1130Bus *_bus; ///< The bus where all chips are connected.
+  uint8_t _chipCount; ///< The number of chips in the group.
+  uint8_t _chipAddresses[cMaximumChipCount]; ///< The address of each chip.
+  uint16_t _activeChips; ///< One bit for each chip which receives writes.
+  Status _lastError; ///< The status of the last failed transmission.
+  uint8_t _transmissionSize; ///< The number of bytes in the transmission buffer.
+  uint8_t _transmission[cMaximumTransmissionSize]; ///< The buffer for the current transmission.
+  AS1130 _chip; ///< The chip instance which writes to all chips.
+};
+
+
+}
+
+
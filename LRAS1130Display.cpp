@@ -0,0 +1,191 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#include "LRAS1130Display.h"
+
+
+#ifdef ARDUINO_ARCH_AVR
+// Make it compatible with the standart
+#include <string.h>
+namespace std { using ::memset; }
+#else
+#include <cstring>
+#endif
+
+
+namespace lr {
+
+
+AS1130Display::AS1130Display(Orientation orientation, uint8_t columns, uint8_t rows, uint8_t firstFrameIndex)
+  : _orientation(orientation),
+    _columns(columns),
+    _rows(rows),
+    _firstFrameIndex(firstFrameIndex),
+    _dirtyTiles(0),
+    _displayedFrames(0)
+{
+  if (_columns * _rows > cMaximumTileCount) {
+    _rows = cMaximumTileCount / _columns;
+  }
+  std::memset(_chips, 0, sizeof(_chips));
+  std::memset(_tiles, 0, sizeof(_tiles));
+  invalidate();
+}
+
+
+void AS1130Display::setChip(uint8_t column, uint8_t row, AS1130 &chip)
+{
+  if (column < _columns && row < _rows) {
+    const uint8_t tileIndex = row * _columns + column;
+    _chips[tileIndex] = &chip;
+    _dirtyTiles |= (1U<<tileIndex);
+  }
+}
+
+
+void AS1130Display::setupSynchronization(AS1130::ClockFrequency clockFrequency)
+{
+  bool isFirst = true;
+  for (uint8_t tileIndex = 0; tileIndex < cMaximumTileCount; ++tileIndex) {
+    if (_chips[tileIndex] != nullptr) {
+      if (isFirst) {
+        _chips[tileIndex]->setClockSynchronization(AS1130::SynchronizationOut, clockFrequency);
+        isFirst = false;
+      } else {
+        _chips[tileIndex]->setClockSynchronization(AS1130::SynchronizationIn, clockFrequency);
+      }
+    }
+  }
+}
+
+
+uint16_t AS1130Display::getWidth() const
+{
+  return static_cast<uint16_t>(_columns) * getTileWidth();
+}
+
+
+uint16_t AS1130Display::getHeight() const
+{
+  return static_cast<uint16_t>(_rows) * getTileHeight();
+}
+
+
+void AS1130Display::setPixel(uint16_t x, uint16_t y, bool enabled)
+{
+  uint8_t registerIndex;
+  uint8_t bitMask;
+  const uint8_t tileIndex = getPixelLocation(x, y, registerIndex, bitMask);
+  if (tileIndex >= cMaximumTileCount) {
+    return;
+  }
+  uint8_t &data = _tiles[tileIndex].registers[registerIndex];
+  const uint8_t newData = (enabled ? (data | bitMask) : (data & ~bitMask));
+  if (newData != data) {
+    data = newData;
+    _dirtyTiles |= (1U<<tileIndex);
+  }
+}
+
+
+bool AS1130Display::getPixel(uint16_t x, uint16_t y) const
+{
+  uint8_t registerIndex;
+  uint8_t bitMask;
+  const uint8_t tileIndex = getPixelLocation(x, y, registerIndex, bitMask);
+  if (tileIndex >= cMaximumTileCount) {
+    return false;
+  }
+  return (_tiles[tileIndex].registers[registerIndex] & bitMask) != 0;
+}
+
+
+void AS1130Display::fill(bool enabled)
+{
+  const uint8_t tileCount = _columns * _rows;
+  for (uint8_t tileIndex = 0; tileIndex < tileCount; ++tileIndex) {
+    AS1130FrameData &tile = _tiles[tileIndex];
+    for (uint8_t x = 0; x < getTileWidth(); ++x) {
+      for (uint8_t y = 0; y < getTileHeight(); ++y) {
+        const uint8_t ledIndex = (_orientation == Orientation12x11)
+          ? AS1130::getLedIndex12x11(x, y) : AS1130::getLedIndex24x5(x, y);
+        const uint8_t registerIndex = ((ledIndex>>4)*2) + ((ledIndex>>3)&1);
+        const uint8_t bitMask = (1<<(ledIndex&7));
+        if (enabled) {
+          tile.registers[registerIndex] |= bitMask;
+        } else {
+          tile.registers[registerIndex] &= ~bitMask;
+        }
+      }
+    }
+  }
+  invalidate();
+}
+
+
+void AS1130Display::invalidate()
+{
+  _dirtyTiles = static_cast<uint16_t>((1UL<<(_columns * _rows)) - 1);
+}
+
+
+void AS1130Display::flush()
+{
+  uint16_t switchedTiles = 0;
+  // Write all changed tiles into the hidden frames.
+  for (uint8_t tileIndex = 0; tileIndex < cMaximumTileCount; ++tileIndex) {
+    const uint16_t tileMask = (1U<<tileIndex);
+    if ((_dirtyTiles & tileMask) != 0 && _chips[tileIndex] != nullptr) {
+      const uint8_t frameIndex = _firstFrameIndex + ((_displayedFrames & tileMask) != 0 ? 0 : 1);
+      _chips[tileIndex]->setOnOffFrameRaw(frameIndex, _tiles[tileIndex]);
+      switchedTiles |= tileMask;
+    }
+  }
+  // Switch all chips as fast as possible.
+  for (uint8_t tileIndex = 0; tileIndex < cMaximumTileCount; ++tileIndex) {
+    const uint16_t tileMask = (1U<<tileIndex);
+    if ((switchedTiles & tileMask) != 0) {
+      _displayedFrames ^= tileMask;
+      const uint8_t frameIndex = _firstFrameIndex + ((_displayedFrames & tileMask) != 0 ? 1 : 0);
+      _chips[tileIndex]->startPicture(frameIndex);
+    }
+  }
+  _dirtyTiles &= ~switchedTiles;
+}
+
+
+uint8_t AS1130Display::getPixelLocation(uint16_t x, uint16_t y, uint8_t &registerIndex, uint8_t &bitMask) const
+{
+  if (x >= getWidth() || y >= getHeight()) {
+    return cMaximumTileCount;
+  }
+  const uint8_t column = x / getTileWidth();
+  const uint8_t row = y / getTileHeight();
+  const uint8_t localX = x - column * getTileWidth();
+  const uint8_t localY = y - row * getTileHeight();
+  const uint8_t ledIndex = (_orientation == Orientation12x11)
+    ? AS1130::getLedIndex12x11(localX, localY) : AS1130::getLedIndex24x5(localX, localY);
+  registerIndex = ((ledIndex>>4)*2) + ((ledIndex>>3)&1);
+  bitMask = (1<<(ledIndex&7));
+  return row * _columns + column;
+}
+
+
+}
+
+
@@ -0,0 +1,181 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#pragma once
+
+
+#include "LRAS1130.h"
+
+
+namespace lr {
+
+
+/// @brief A display with multiple chips and one framebuffer.
+///
+/// The display combines up to 16 chips, arranged as tiles in columns and
+/// rows, into one large framebuffer. All tiles use the same orientation,
+/// either 12x11 or 24x5 LEDs. The framebuffer is stored in the register
+/// format of the chips, so flushing a tile needs no conversion.
+///
+/// Each chip uses two on/off frames: one frame is displayed while the
+/// other one is written. flush() first writes all changed tiles into the
+/// hidden frames and then switches the changed chips one after the other.
+/// Each switch is a register bank selection and one register write, two
+/// short transactions which take about 0.15ms per chip at 400kHz. So the
+/// last chip switches about 0.15ms times the number of chips after the
+/// first one. Sharing the clock with setupSynchronization() keeps the scan
+/// and PWM cycles of the chips in phase, but it does not remove this delay.
+///
+/// The chips have to be initialized as usual (RAM configuration, PWM set,
+/// current source, scan limit), but do not start a picture or movie.
+///
+/// Example:
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// AS1130 chip0(AS1130::ChipAddress0);
+/// AS1130 chip1(AS1130::ChipAddress1);
+/// AS1130Display display(AS1130Display::Orientation24x5, 2, 1);
+/// display.setChip(0, 0, chip0);
+/// display.setChip(1, 0, chip1);
+/// display.setupSynchronization(AS1130::Clock1MHz);
+/// display.setPixel(30, 2, true);
+/// display.flush();
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+class AS1130Display
+{
+public:
+  /// @brief The orientation of the tiles.
+  ///
+  enum Orientation : uint8_t {
+    Orientation12x11, ///< Each chip displays 12x11 pixels.
+    Orientation24x5, ///< Each chip displays 24x5 pixels.
+  };
+
+  /// @brief The maximum number of chips in a display.
+  ///
+  static const uint8_t cMaximumTileCount = 16;
+
+public:
+  /// @brief Create a new display.
+  ///
+  /// @param orientation The orientation of all tiles.
+  /// @param columns The number of tiles in horizontal direction.
+  /// @param rows The number of tiles in vertical direction. The number of
+  ///   columns multiplied with the number of rows has to be 16 or less.
+  /// @param firstFrameIndex The first of the two on/off frames used on each chip.
+  ///
+  AS1130Display(Orientation orientation, uint8_t columns, uint8_t rows, uint8_t firstFrameIndex = 0);
+
+public:
+  /// @brief Assign a chip to a tile.
+  ///
+  /// @param column The column of the tile.
+  /// @param row The row of the tile.
+  /// @param chip The chip which displays the tile.
+  ///
+  void setChip(uint8_t column, uint8_t row, AS1130 &chip);
+
+  /// @brief Configure the clock synchronization of all chips.
+  ///
+  /// The chip of the first tile sends its clock to the synchronization pin,
+  /// all other chips use this clock. Connect the synchronization pins of all
+  /// chips for this.
+  ///
+  /// @param clockFrequency The clock frequency of the first chip.
+  ///
+  void setupSynchronization(AS1130::ClockFrequency clockFrequency);
+
+  /// @brief Get the width of the display in pixels.
+  ///
+  uint16_t getWidth() const;
+
+  /// @brief Get the height of the display in pixels.
+  ///
+  uint16_t getHeight() const;
+
+  /// @brief Set a pixel in the framebuffer.
+  ///
+  /// The coordinates are bounds checked.
+  ///
+  /// @param x The X coordinate of the pixel.
+  /// @param y The Y coordinate of the pixel.
+  /// @param enabled True if the LED is on.
+  ///
+  void setPixel(uint16_t x, uint16_t y, bool enabled);
+
+  /// @brief Get a pixel from the framebuffer.
+  ///
+  /// @param x The X coordinate of the pixel.
+  /// @param y The Y coordinate of the pixel.
+  /// @return True if the LED is on.
+  ///
+  bool getPixel(uint16_t x, uint16_t y) const;
+
+  /// @brief Set all pixels of the framebuffer.
+  ///
+  /// @param enabled True to enable all LEDs, false to disable them.
+  ///
+  void fill(bool enabled);
+
+  /// @brief Mark all tiles as changed.
+  ///
+  /// The next flush() will write all tiles.
+  ///
+  void invalidate();
+
+  /// @brief Check if there are changed tiles.
+  ///
+  inline bool isDirty() const { return _dirtyTiles != 0; }
+
+  /// @brief Write all changed tiles to the chips and display them.
+  ///
+  /// The chips are switched in sequence, see the class description for the
+  /// delay between the chips.
+  ///
+  void flush();
+
+private:
+  /// @brief Get the register byte and bit mask for a pixel.
+  ///
+  /// @return The tile index, or cMaximumTileCount if the pixel is outside the display.
+  ///
+  uint8_t getPixelLocation(uint16_t x, uint16_t y, uint8_t &registerIndex, uint8_t &bitMask) const;
+
+  /// @brief Get the width of a tile.
+  ///
+  inline uint8_t getTileWidth() const { return _orientation == Orientation12x11 ? 12 : 24; }
+
+  /// @brief Get the height of a tile.
+  ///
+  inline uint8_t getTileHeight() const { return _orientation == Orientation12x11 ? 11 : 5; }
+
+private:
+  Orientation _orientation; ///< The orientation of the tiles.
+  uint8_t _columns; ///< The number of tile columns.
+  uint8_t _rows; ///< The number of tile rows.
+  uint8_t _firstFrameIndex; ///< The first of the two frames used on the chips.
+  uint16_t _dirtyTiles; ///< One bit for each changed tile.
+  uint16_t _displayedFrames; ///< One bit for each tile, set if the second frame is displayed.
+  AS1130 *_chips[cMaximumTileCount]; ///< The chip for each tile.
+  AS1130FrameData _tiles[cMaximumTileCount]; ///< The framebuffer, one register image for each tile.
+};
+
+
+}
+
+
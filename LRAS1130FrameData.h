@@ -0,0 +1,193 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#pragma once
+
+
+#include "LRAS1130IndexList.h"
+
+#ifdef ARDUINO_ARCH_AVR
+#include <inttypes.h>
+#include <stddef.h>
+#else
+#include <cinttypes>
+#include <cstddef>
+#endif
+
+
+namespace lr {
+
+
+/// @brief The register data of one on/off frame.
+///
+/// This structure holds the 24 register bytes of an on/off frame, exactly
+/// as they are written to the chip. All conversion functions are `constexpr`,
+/// so static frames can be converted at compile time and stored in flash
+/// memory. Use AS1130::setOnOffFrameRaw() to write the data to the chip.
+///
+/// Example:
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// const AS1130FrameData frame PROGMEM = AS1130FrameData::fromText24x5(
+///   "########################"
+///   "#......................#"
+///   "#......................#"
+///   "#......................#"
+///   "########################");
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+struct AS1130FrameData
+{
+  /// @brief The number of register bytes for one frame.
+  ///
+  static const uint8_t cSize = 0x18;
+
+  uint8_t registers[cSize]; ///< The register data.
+
+  /// @brief Convert a 24x5 bitmap into frame data.
+  ///
+  /// @param bitmap The bitmap with 15 bytes, in the same format as used for AS1130Picture24x5.
+  /// @param pwmSetIndex The PWM set index for this frame.
+  /// @return The frame data.
+  ///
+  static constexpr AS1130FrameData from24x5(const uint8_t (&bitmap)[15], uint8_t pwmSetIndex = 0) {
+    return build<Bitmap24x5>(Bitmap24x5{bitmap}, pwmSetIndex, typename AS1130MakeIndexList<cSize>::Type());
+  }
+
+  /// @brief Convert a 12x11 bitmap into frame data.
+  ///
+  /// @param bitmap The bitmap with 17 bytes, in the same format as used for AS1130Picture12x11.
+  /// @param pwmSetIndex The PWM set index for this frame.
+  /// @return The frame data.
+  ///
+  static constexpr AS1130FrameData from12x11(const uint8_t (&bitmap)[17], uint8_t pwmSetIndex = 0) {
+    return build<Bitmap12x11>(Bitmap12x11{bitmap}, pwmSetIndex, typename AS1130MakeIndexList<cSize>::Type());
+  }
+
+  /// @brief Convert ASCII art with 24x5 pixels into frame data.
+  ///
+  /// The text has to contain exactly 120 characters, row by row. The characters
+  /// `.` and space are dark pixels, all other characters enable the pixel.
+  ///
+  /// @param text The text with the pixels.
+  /// @param pwmSetIndex The PWM set index for this frame.
+  /// @return The frame data.
+  ///
+  template<size_t N>
+  static constexpr AS1130FrameData fromText24x5(const char (&text)[N], uint8_t pwmSetIndex = 0) {
+    static_assert(N == 24*5+1, "The text for a 24x5 frame needs exactly 120 characters.");
+    return build<Text24x5>(Text24x5{text}, pwmSetIndex, typename AS1130MakeIndexList<cSize>::Type());
+  }
+
+  /// @brief Convert ASCII art with 12x11 pixels into frame data.
+  ///
+  /// The text has to contain exactly 132 characters, row by row. The characters
+  /// `.` and space are dark pixels, all other characters enable the pixel.
+  ///
+  /// @param text The text with the pixels.
+  /// @param pwmSetIndex The PWM set index for this frame.
+  /// @return The frame data.
+  ///
+  template<size_t N>
+  static constexpr AS1130FrameData fromText12x11(const char (&text)[N], uint8_t pwmSetIndex = 0) {
+    static_assert(N == 12*11+1, "The text for a 12x11 frame needs exactly 132 characters.");
+    return build<Text12x11>(Text12x11{text}, pwmSetIndex, typename AS1130MakeIndexList<cSize>::Type());
+  }
+
+  /// @name Compile-Time Helpers.
+  /// Internal types and functions used for the conversion.
+  /// @{
+
+  /// @brief Access to a bitmap in 24x5 layout.
+  ///
+  struct Bitmap24x5 {
+    const uint8_t (&bitmap)[15]; ///< The bitmap.
+    constexpr bool getLed(uint8_t segment, uint8_t led) const {
+      return led < 10 && getPixel(segment*2 + (led >= 5 ? 1 : 0), led%5);
+    }
+    constexpr bool getPixel(uint8_t x, uint8_t y) const {
+      return ((bitmap[y*3+(x>>3)] >> (7-(x&7))) & 1) != 0;
+    }
+  };
+
+  /// @brief Access to a bitmap in 12x11 layout.
+  ///
+  struct Bitmap12x11 {
+    const uint8_t (&bitmap)[17]; ///< The bitmap.
+    constexpr bool getLed(uint8_t segment, uint8_t led) const {
+      return led < 11 && getBit(led*12 + segment);
+    }
+    constexpr bool getBit(uint8_t position) const {
+      return ((bitmap[position>>3] >> (7-(position&7))) & 1) != 0;
+    }
+  };
+
+  /// @brief Access to ASCII art in 24x5 layout.
+  ///
+  struct Text24x5 {
+    const char *text; ///< The text.
+    constexpr bool getLed(uint8_t segment, uint8_t led) const {
+      return led < 10 && isPixelSet(text[(led%5)*24 + segment*2 + (led >= 5 ? 1 : 0)]);
+    }
+  };
+
+  /// @brief Access to ASCII art in 12x11 layout.
+  ///
+  struct Text12x11 {
+    const char *text; ///< The text.
+    constexpr bool getLed(uint8_t segment, uint8_t led) const {
+      return led < 11 && isPixelSet(text[led*12 + segment]);
+    }
+  };
+
+  /// @brief Check if a character in ASCII art enables a pixel.
+  ///
+  static constexpr bool isPixelSet(char c) {
+    return c != '.' && c != ' ';
+  }
+
+  /// @brief Collect the bits for a number of LEDs in a segment.
+  ///
+  template<typename Source>
+  static constexpr uint8_t getBits(const Source &source, uint8_t segment, uint8_t firstLed, uint8_t count) {
+    return count == 0 ? 0 : static_cast<uint8_t>(
+      (source.getLed(segment, firstLed + count - 1) ? (1 << (count - 1)) : 0)
+      | getBits(source, segment, firstLed, count - 1));
+  }
+
+  /// @brief Get one register byte.
+  ///
+  template<typename Source>
+  static constexpr uint8_t getRegister(const Source &source, uint8_t index, uint8_t pwmSetIndex) {
+    return (index & 1) == 0
+      ? getBits(source, index>>1, 0, 8)
+      : static_cast<uint8_t>(getBits(source, index>>1, 8, 3) | (index == 1 ? (pwmSetIndex<<5) : 0));
+  }
+
+  /// @brief Build the frame data from all register bytes.
+  ///
+  template<typename Source, uint16_t... Indexes>
+  static constexpr AS1130FrameData build(const Source &source, uint8_t pwmSetIndex, AS1130IndexList<Indexes...>) {
+    return AS1130FrameData{{getRegister(source, Indexes, pwmSetIndex)...}};
+  }
+
+  /// @}
+};
+
+
+}
+
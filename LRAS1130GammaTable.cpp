@@ -0,0 +1,41 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#include "LRAS1130GammaTable.h"
+
+
+#ifdef ARDUINO_ARCH_AVR
+#include <avr/pgmspace.h>
+#endif
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+
+namespace lr {
+
+
+const AS1130GammaTable AS1130GammaTable::cGamma18 PROGMEM = AS1130GammaTable::create(1.8);
+const AS1130GammaTable AS1130GammaTable::cGamma22 PROGMEM = AS1130GammaTable::create(2.2);
+const AS1130GammaTable AS1130GammaTable::cGamma25 PROGMEM = AS1130GammaTable::create(2.5);
+const AS1130GammaTable AS1130GammaTable::cGamma28 PROGMEM = AS1130GammaTable::create(2.8);
+
+
+}
+
+
@@ -0,0 +1,140 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#pragma once
+
+
+#include "LRAS1130IndexList.h"
+
+#ifdef ARDUINO_ARCH_AVR
+#include <inttypes.h>
+#else
+#include <cinttypes>
+#endif
+
+
+namespace lr {
+
+
+/// @brief A lookup table for the gamma correction of PWM values.
+///
+/// The table maps each of the 256 linear brightness values to the PWM value
+/// which is written to the chip. The table is generated at compile time
+/// using create(), so no floating point code is required on the device.
+/// Use AS1130::setGammaTable_P() to apply a table to all PWM values.
+///
+/// The library provides tables for the most common gamma values. You can
+/// create your own table like this:
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// const AS1130GammaTable gammaTable PROGMEM = AS1130GammaTable::create(2.4);
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+struct AS1130GammaTable
+{
+  /// @brief The number of values in the table.
+  ///
+  static const uint16_t cSize = 256;
+
+  uint8_t values[cSize]; ///< The PWM value for each brightness.
+
+  /// @brief Create a gamma table for the given gamma value.
+  ///
+  /// @param gamma The gamma value, e.g. 2.2. A value of 1.0 creates a linear table.
+  /// @return The gamma table.
+  ///
+  static constexpr AS1130GammaTable create(double gamma) {
+    return build(gamma, typename AS1130MakeIndexList<cSize>::Type());
+  }
+
+  /// @name Predefined Tables.
+  /// Gamma tables in program memory, for AS1130::setGammaTable_P().
+  /// @{
+
+  static const AS1130GammaTable cGamma18; ///< Gamma 1.8
+  static const AS1130GammaTable cGamma22; ///< Gamma 2.2
+  static const AS1130GammaTable cGamma25; ///< Gamma 2.5
+  static const AS1130GammaTable cGamma28; ///< Gamma 2.8
+
+  /// @}
+
+  /// @name Compile-Time Helpers.
+  /// Internal types and functions used for the calculation.
+  /// @{
+
+  /// @brief The natural logarithm of 2.
+  ///
+  static constexpr double ln2() {
+    return 0.69314718055994530942;
+  }
+
+  /// @brief Sum up the series `2*(z + z^3/3 + z^5/5 + ...)`.
+  ///
+  static constexpr double lnSeries(double z2, double power, uint8_t n) {
+    return n > 41 ? 0.0 : 2.0*power/n + lnSeries(z2, power*z2, n+2);
+  }
+
+  /// @brief The natural logarithm for a value between 0.5 and 1.
+  ///
+  static constexpr double lnReduced(double x) {
+    return lnSeries(((x-1.0)/(x+1.0))*((x-1.0)/(x+1.0)), (x-1.0)/(x+1.0), 1);
+  }
+
+  /// @brief The natural logarithm for a value between 0 and 1.
+  ///
+  static constexpr double ln(double x) {
+    return x < 0.5 ? ln(x*2.0) - ln2() : lnReduced(x);
+  }
+
+  /// @brief Sum up the series `1 + y + y^2/2! + y^3/3! + ...`.
+  ///
+  static constexpr double expSeries(double y, double term, uint8_t n) {
+    return n > 20 ? term : term + expSeries(y, term*y/n, n+1);
+  }
+
+  /// @brief The square of a value.
+  ///
+  static constexpr double square(double x) {
+    return x*x;
+  }
+
+  /// @brief The exponential function for a negative value.
+  ///
+  static constexpr double exp(double y) {
+    return y < -1.0 ? square(exp(y*0.5)) : expSeries(y, 1.0, 1);
+  }
+
+  /// @brief Calculate the corrected value for one index.
+  ///
+  static constexpr uint8_t getValue(double gamma, uint16_t index) {
+    return index == 0 ? 0 : static_cast<uint8_t>(255.0*exp(gamma*ln(index/255.0)) + 0.5);
+  }
+
+  /// @brief Build the table from all values.
+  ///
+  template<uint16_t... Indexes>
+  static constexpr AS1130GammaTable build(double gamma, AS1130IndexList<Indexes...>) {
+    return AS1130GammaTable{{getValue(gamma, Indexes)...}};
+  }
+
+  /// @}
+};
+
+
+}
+
+
@@ -0,0 +1,109 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#include "LRAS1130.h"
+
+
+#ifdef ARDUINO_ARCH_AVR
+// Make it compatible with the standart
+#include <string.h>
+namespace std { using ::memset; } 
+namespace std { using ::memcpy; }
+#else
+#include <cstring>
+#endif
+
+
+namespace lr {
+
+
+AS1130GrayPicture12x11::AS1130GrayPicture12x11()
+{
+  std::memset(_data, 0, getDataByteCount());
+}
+
+
+AS1130GrayPicture12x11::AS1130GrayPicture12x11(const uint8_t *data)
+{
+  std::memcpy(_data, data, getDataByteCount());
+}
+
+
+void AS1130GrayPicture12x11::setPixel(uint8_t x, uint8_t y, uint8_t value)
+{
+  if (x < getWidth() && y < getHeight()) {
+    _data[y*getWidth()+x] = value;
+  }
+}
+
+
+uint8_t AS1130GrayPicture12x11::getPixel(uint8_t x, uint8_t y) const
+{
+  if (x < getWidth() && y < getHeight()) {
+    return _data[y*getWidth()+x];
+  } else {
+    return 0;
+  }
+}
+
+
+void AS1130GrayPicture12x11::fill(uint8_t value)
+{
+  std::memset(_data, value, getDataByteCount());
+}
+
+
+void AS1130GrayPicture12x11::writeRegisters(uint8_t *registerData, uint8_t pwmSetIndex) const
+{
+  // Each segment is one column, the LEDs are the rows.
+  const uint8_t *column = _data;
+  for (uint8_t x = 0; x < getWidth(); ++x) {
+    uint16_t bits = 0;
+    const uint8_t *pixel = column + getDataByteCount();
+    for (uint8_t y = 0; y < getHeight(); ++y) {
+      pixel -= getWidth();
+      bits <<= 1;
+      if (*pixel != 0) {
+        bits |= 1;
+      }
+    }
+    registerData[x*2] = static_cast<uint8_t>(bits);
+    registerData[x*2+1] = static_cast<uint8_t>(bits>>8);
+    ++column;
+  }
+  registerData[1] |= (pwmSetIndex<<5);
+}
+
+
+void AS1130GrayPicture12x11::writePwmData(uint8_t *pwmData) const
+{
+  // The PWM data contains 11 values for each column.
+  for (uint8_t x = 0; x < getWidth(); ++x) {
+    const uint8_t *pixel = _data + x;
+    for (uint8_t y = 0; y < getHeight(); ++y) {
+      *pwmData = *pixel;
+      ++pwmData;
+      pixel += getWidth();
+    }
+  }
+}
+
+
+}
+
+
@@ -0,0 +1,123 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#pragma once
+
+
+#ifdef ARDUINO_ARCH_AVR
+#include <inttypes.h>
+#else
+#include <cinttypes>
+#endif
+
+
+namespace lr {
+
+
+/// @brief One grayscale bitmap in 24x5 layout.
+///
+/// Each pixel has an intensity between 0x00 (off) and 0xff (full brightness).
+/// Use AS1130::setGrayFrame() to display the bitmap using an on/off frame
+/// and a matching blink&PWM set.
+///
+class AS1130GrayPicture24x5
+{
+public:
+  /// @brief Create a empty bitmap.
+  ///
+  AS1130GrayPicture24x5();
+
+  /// @brief Create a bitmap using existing intensity values.
+  ///
+  /// @param data An array with 120 intensity values, row by row.
+  ///
+  AS1130GrayPicture24x5(const uint8_t *data);
+
+public:
+  /// @brief Set the intensity of a pixel in this bitmap.
+  ///
+  /// The coordinates are bounds checked.
+  ///
+  /// @param x The X coordinate of the pixel.
+  /// @param y The Y coordinate of the pixel.
+  /// @param value The intensity of the pixel. Zero switches the LED off.
+  ///
+  void setPixel(uint8_t x, uint8_t y, uint8_t value);
+
+  /// @brief Get the intensity of a single pixel.
+  ///
+  /// @param x The X coordinate of the pixel.
+  /// @param y The Y coordinate of the pixel.
+  /// @return The intensity of the pixel.
+  ///
+  uint8_t getPixel(uint8_t x, uint8_t y) const;
+
+  /// @brief Set the intensity of all pixels.
+  ///
+  /// @param value The intensity for all pixels.
+  ///
+  void fill(uint8_t value);
+
+  /// @brief Get the width of this bitmap.
+  ///
+  /// @return The width of the bitmap in pixels.
+  ///
+  inline static uint8_t getWidth() { return 24; }
+
+  /// @brief Get the height of this bitmap.
+  ///
+  /// @return The height of the bitmap in pixels.
+  ///
+  inline static uint8_t getHeight() { return 5; }
+
+  /// @brief Get the number of raw byte for this bitmap.
+  ///
+  /// @return The number of raw bytes used to store this bitmap.
+  ///
+  inline static uint8_t getDataByteCount() { return 120; }
+
+  /// @brief Access the raw intensity data.
+  ///
+  /// @return A pointer to the intensity values, row by row.
+  ///
+  inline const uint8_t* getData() const { return _data; }
+
+  /// @brief Write the on/off frame registers for this bitmap.
+  ///
+  /// All LEDs with an intensity greater than zero are enabled.
+  ///
+  /// @param registerData A pointer to an array of 24 bytes for all frame registers.
+  /// @param pwmSetIndex The PWM index to write to the register data.
+  ///
+  void writeRegisters(uint8_t *registerData, uint8_t pwmSetIndex) const;
+
+  /// @brief Write the PWM data for this bitmap.
+  ///
+  /// @param pwmData A pointer to an array of 132 bytes, which receives the PWM values
+  ///   in the order of the chip.
+  ///
+  void writePwmData(uint8_t *pwmData) const;
+
+private:
+  uint8_t _data[120]; ///< The intensity values.
+};
+
+
+}
+
+
@@ -0,0 +1,48 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#pragma once
+
+
+#ifdef ARDUINO_ARCH_AVR
+#include <inttypes.h>
+#else
+#include <cinttypes>
+#endif
+
+
+namespace lr {
+
+
+/// @brief A list of indexes, used to generate tables at compile time.
+///
+/// This is an internal helper for AS1130FrameData and AS1130GammaTable.
+///
+template<uint16_t... Indexes> struct AS1130IndexList {};
+
+/// @brief Create a list with the indexes from 0 to Count-1.
+///
+template<uint16_t Count, uint16_t... Indexes> struct AS1130MakeIndexList : AS1130MakeIndexList<Count-1, Count-1, Indexes...> {};
+
+/// @brief The end of the index list recursion.
+///
+template<uint16_t... Indexes> struct AS1130MakeIndexList<0, Indexes...> { typedef AS1130IndexList<Indexes...> Type; };
+
+
+}
+
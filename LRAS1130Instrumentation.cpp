@@ -0,0 +1,445 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#include "LRAS1130Instrumentation.h"
+#ifdef LRAS1130_INSTRUMENTATION
+
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+#ifdef ARDUINO_ARCH_AVR
+#include <avr/pgmspace.h>
+#include <stdio.h>
+#include <string.h>
+namespace std { using ::memset; using ::snprintf; }
+#else
+#include <cstdio>
+#include <cstring>
+#endif
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+
+namespace lr {
+
+
+namespace {
+
+
+/// The address for the register selection.
+///
+const uint8_t cRegisterSelectionAddress = 0xfd;
+
+/// The maximum length of a line in the dump, including the terminating zero.
+///
+/// A counter line has the type, the longest name (31 characters), five fields
+/// with up to 10 digits and the call count: 116 bytes. The histogram line has
+/// eight entries with limits up to 4 digits and counts up to 10 digits: 141 bytes.
+///
+const uint8_t cLineSize = 144;
+
+/// The names of all operations, separated by zero bytes.
+///
+const char cOperationNames[] PROGMEM =
+  "other\0"
+  "isChipConnected\0"
+  "setRamConfiguration\0"
+  "setOnOffFrame\0"
+  "setOnOffFrame24x5\0"
+  "setOnOffFrame12x11\0"
+  "setOnOffFrameRaw\0"
+  "setOnOffFrameRaw_P\0"
+  "setOnOffFrameAllOff\0"
+  "setOnOffFrameAllOn\0"
+  "setBlinkAndPwmSetAll\0"
+  "setPwmValue\0"
+  "setPwmSet\0"
+  "setPwmSet12x11\0"
+  "setPwmSet24x5\0"
+  "setBlinkSet\0"
+  "setGrayFrame\0"
+  "setDotCorrection\0"
+  "setInterruptMask\0"
+  "setInterruptFrame\0"
+  "setInterfaceMonitoring\0"
+  "setClockSynchronization\0"
+  "setCurrentSource\0"
+  "setScanLimit\0"
+  "setBlinkEnabled\0"
+  "startPicture\0"
+  "stopPicture\0"
+  "setMovieEndFrame\0"
+  "setMovieFrameCount\0"
+  "setFrameDelayMs\0"
+  "setScrollingEnabled\0"
+  "setScrollingBlockSize\0"
+  "setScrollingDirection\0"
+  "setFrameFadingEnabled\0"
+  "setBlinkFrequency\0"
+  "setMovieLoopCount\0"
+  "startMovie\0"
+  "stopMovie\0"
+  "setLowVddResetEnabled\0"
+  "setLowVddStatusEnabled\0"
+  "setLedErrorCorrectionEnabled\0"
+  "setDotCorrectionEnabled\0"
+  "setTestAllLedsEnabled\0"
+  "setAutomaticTestEnabled\0"
+  "startChip\0"
+  "stopChip\0"
+  "resetChip\0"
+  "runManualTest\0"
+  "getLedStatus\0"
+  "readLedStatusMap\0"
+  "readOnOffFrame\0"
+  "readBlinkSet\0"
+  "readPwmSet\0"
+  "readControlRegisters\0"
+  "isLedTestRunning\0"
+  "isMovieRunning\0"
+  "getDisplayedFrame\0"
+  "getInterruptStatus\0"
+  "readStatusSnapshot\0"
+  "getStatusSnapshot\0"
+  "synchronizeControlRegisterCache\0";
+
+/// The names of all register banks, separated by zero bytes.
+///
+const char cBankNames[] PROGMEM =
+  "none\0"
+  "frame\0"
+  "set\0"
+  "dot\0"
+  "control\0";
+
+
+/// Copy a name from a list of names.
+///
+/// @param names The names, separated by zero bytes.
+/// @param index The index of the name.
+/// @param buffer The buffer for the name, with at least 32 bytes.
+///
+void copyName(const char *names, uint8_t index, char *buffer)
+{
+#ifdef ARDUINO_ARCH_AVR
+  while (index > 0) {
+    if (pgm_read_byte(names++) == '\0') {
+      --index;
+    }
+  }
+  strncpy_P(buffer, names, 31);
+#else
+  while (index > 0) {
+    if (*names++ == '\0') {
+      --index;
+    }
+  }
+  std::strncpy(buffer, names, 31);
+#endif
+  buffer[31] = '\0';
+}
+
+
+/// Get the register bank for a register selection.
+///
+AS1130Instrumentation::Bank getBank(uint8_t registerSelection)
+{
+  if (registerSelection >= 0x01 && registerSelection <= 0x24) {
+    return AS1130Instrumentation::BankOnOffFrame;
+  } else if (registerSelection >= 0x40 && registerSelection <= 0x45) {
+    return AS1130Instrumentation::BankBlinkAndPwmSet;
+  } else if (registerSelection == 0x80) {
+    return AS1130Instrumentation::BankDotCorrection;
+  } else if (registerSelection == 0xc0) {
+    return AS1130Instrumentation::BankControl;
+  }
+  return AS1130Instrumentation::BankNone;
+}
+
+
+/// Add the counters from one set to another.
+///
+void addCounters(AS1130Instrumentation::Counters &sum, const AS1130Instrumentation::Counters &counters)
+{
+  sum.callCount += counters.callCount;
+  sum.errorCount += counters.errorCount;
+  sum.transactionCount += counters.transactionCount;
+  sum.writtenByteCount += counters.writtenByteCount;
+  sum.readByteCount += counters.readByteCount;
+  sum.microseconds += counters.microseconds;
+}
+
+
+/// Format a line with counters.
+///
+/// @return The length of the line.
+///
+int formatCounters(char *line, const char *type, const char *name, const AS1130Instrumentation::Counters &counters)
+{
+  return std::snprintf(line, cLineSize, "%s %s tx=%lu wr=%lu rd=%lu err=%u us=%lu",
+    type, name,
+    static_cast<unsigned long>(counters.transactionCount),
+    static_cast<unsigned long>(counters.writtenByteCount),
+    static_cast<unsigned long>(counters.readByteCount),
+    static_cast<unsigned>(counters.errorCount),
+    static_cast<unsigned long>(counters.microseconds));
+}
+
+
+#ifdef ARDUINO
+/// Write a line of the dump to a print object.
+///
+void writeLineToPrint(void *context, const char *line)
+{
+  static_cast<Print*>(context)->println(line);
+}
+#else
+/// Write a line of the dump to a file.
+///
+void writeLineToFile(void *context, const char *line)
+{
+  std::fprintf(static_cast<std::FILE*>(context), "%s\n", line);
+}
+#endif
+
+
+}
+
+
+AS1130Instrumentation::Scope::Scope(AS1130Instrumentation *instrumentation, Operation operation)
+  : _instrumentation(nullptr)
+{
+  if (instrumentation != nullptr && instrumentation->_operation == OperationOther) {
+    instrumentation->_operation = operation;
+    if (instrumentation->_operationCounters != nullptr) {
+      ++instrumentation->_operationCounters[operation].callCount;
+    }
+    _instrumentation = instrumentation;
+  }
+}
+
+
+AS1130Instrumentation::Scope::~Scope()
+{
+  if (_instrumentation != nullptr) {
+    _instrumentation->_operation = OperationOther;
+  }
+}
+
+
+AS1130Instrumentation::AS1130Instrumentation(AS1130Bus &bus, Counters *operationCounters)
+  : _bus(&bus),
+    _operationCounters(operationCounters),
+    _operation(OperationOther),
+    _bank(BankNone),
+    _transmissionSize(0),
+    _firstByte(0),
+    _secondByte(0),
+    _startTime(0)
+{
+  reset();
+}
+
+
+void AS1130Instrumentation::reset()
+{
+  if (_operationCounters != nullptr) {
+    std::memset(_operationCounters, 0, sizeof(Counters) * OperationCount);
+  }
+  std::memset(_bankCounters, 0, sizeof(_bankCounters));
+  std::memset(_histogram, 0, sizeof(_histogram));
+}
+
+
+AS1130Instrumentation::Counters AS1130Instrumentation::getOperationCounters(Operation operation) const
+{
+  if (_operationCounters != nullptr) {
+    return _operationCounters[operation];
+  }
+  Counters counters;
+  std::memset(&counters, 0, sizeof(Counters));
+  return counters;
+}
+
+
+AS1130Instrumentation::Counters AS1130Instrumentation::getTotalCounters() const
+{
+  Counters sum;
+  std::memset(&sum, 0, sizeof(Counters));
+  for (uint8_t i = 0; i < BankCount; ++i) {
+    addCounters(sum, _bankCounters[i]);
+  }
+  return sum;
+}
+
+
+#ifdef ARDUINO
+void AS1130Instrumentation::dump(::Print &print) const
+{
+  writeLines(&writeLineToPrint, &print);
+}
+#else
+void AS1130Instrumentation::dump(std::FILE *file) const
+{
+  writeLines(&writeLineToFile, file);
+}
+#endif
+
+
+void AS1130Instrumentation::writeLines(LineWriter lineWriter, void *context) const
+{
+  char line[cLineSize];
+  char name[32];
+  if (_operationCounters != nullptr) {
+    for (uint8_t i = 0; i < OperationCount; ++i) {
+      const Counters &counters = _operationCounters[i];
+      if (counters.callCount == 0 && counters.transactionCount == 0) {
+        continue;
+      }
+      copyName(cOperationNames, i, name);
+      const int length = formatCounters(line, "op", name, counters);
+      if (length > 0 && length < cLineSize) {
+        std::snprintf(line + length, cLineSize - length, " calls=%u", static_cast<unsigned>(counters.callCount));
+      }
+      lineWriter(context, line);
+    }
+  }
+  for (uint8_t i = 0; i < BankCount; ++i) {
+    if (_bankCounters[i].transactionCount == 0) {
+      continue;
+    }
+    copyName(cBankNames, i, name);
+    formatCounters(line, "bank", name, _bankCounters[i]);
+    lineWriter(context, line);
+  }
+  formatCounters(line, "total", "all", getTotalCounters());
+  lineWriter(context, line);
+  int length = std::snprintf(line, cLineSize, "hist");
+  for (uint8_t i = 0; i < cHistogramSize && length > 0 && length < cLineSize; ++i) {
+    if (i < cHistogramSize - 1) {
+      length += std::snprintf(line + length, cLineSize - length, " <%lu:%lu",
+        static_cast<unsigned long>(getHistogramLimit(i)), static_cast<unsigned long>(_histogram[i]));
+    } else {
+      length += std::snprintf(line + length, cLineSize - length, " >=%lu:%lu",
+        static_cast<unsigned long>(getHistogramLimit(i - 1)), static_cast<unsigned long>(_histogram[i]));
+    }
+  }
+  lineWriter(context, line);
+}
+
+
+void AS1130Instrumentation::beginTransmission(uint8_t chipAddress)
+{
+  _transmissionSize = 0;
+  _startTime = _bus->getMicroseconds();
+  _bus->beginTransmission(chipAddress);
+}
+
+
+bool AS1130Instrumentation::write(uint8_t data)
+{
+  if (!_bus->write(data)) {
+    return false;
+  }
+  if (_transmissionSize == 0) {
+    _firstByte = data;
+  } else if (_transmissionSize == 1) {
+    _secondByte = data;
+  }
+  ++_transmissionSize;
+  return true;
+}
+
+
+AS1130Bus::Status AS1130Instrumentation::endTransmission()
+{
+  const Status status = _bus->endTransmission();
+  if (_transmissionSize >= 2 && _firstByte == cRegisterSelectionAddress) {
+    // Count the selection of a bank for the newly selected bank.
+    _bank = (status == StatusSuccess ? getBank(_secondByte) : BankNone);
+  }
+  addTransaction(_transmissionSize, 0, status != StatusSuccess, _startTime);
+  return status;
+}
+
+
+uint8_t AS1130Instrumentation::requestFrom(uint8_t chipAddress, uint8_t count)
+{
+  const uint32_t startTime = _bus->getMicroseconds();
+  const uint8_t receivedCount = _bus->requestFrom(chipAddress, count);
+  addTransaction(0, receivedCount, receivedCount != count, startTime);
+  return receivedCount;
+}
+
+
+uint8_t AS1130Instrumentation::read()
+{
+  return _bus->read();
+}
+
+
+uint8_t AS1130Instrumentation::getBufferSize() const
+{
+  return _bus->getBufferSize();
+}
+
+
+void AS1130Instrumentation::delay(uint16_t milliseconds)
+{
+  _bus->delay(milliseconds);
+}
+
+
+uint32_t AS1130Instrumentation::getMicroseconds() const
+{
+  return _bus->getMicroseconds();
+}
+
+
+void AS1130Instrumentation::addTransaction(uint8_t writtenByteCount, uint8_t readByteCount, bool isError, uint32_t startTime)
+{
+  const uint32_t duration = _bus->getMicroseconds() - startTime;
+  Counters *counters[2] = {&_bankCounters[_bank], nullptr};
+  if (_operationCounters != nullptr) {
+    counters[1] = &_operationCounters[_operation];
+  }
+  for (uint8_t i = 0; i < 2 && counters[i] != nullptr; ++i) {
+    ++counters[i]->transactionCount;
+    counters[i]->writtenByteCount += writtenByteCount;
+    counters[i]->readByteCount += readByteCount;
+    if (isError) {
+      ++counters[i]->errorCount;
+    }
+    counters[i]->microseconds += duration;
+  }
+  uint8_t index = 0;
+  while (index < cHistogramSize - 1 && duration >= getHistogramLimit(index)) {
+    ++index;
+  }
+  ++_histogram[index];
+}
+
+
+}
+
+
+#endif
@@ -0,0 +1,316 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#pragma once
+
+
+// Uncomment the next line, or define LRAS1130_INSTRUMENTATION in the build
+// flags, to compile the bus instrumentation into the library.
+// #define LRAS1130_INSTRUMENTATION
+
+
+#ifdef LRAS1130_INSTRUMENTATION
+
+
+#include "LRAS1130Bus.h"
+
+#ifdef ARDUINO_ARCH_AVR
+#include <inttypes.h>
+#else
+#include <cinttypes>
+#include <cstdio>
+#endif
+
+
+#ifdef ARDUINO
+class Print;
+#endif
+
+
+namespace lr {
+
+
+/// @brief A bus which measures the communication with the chip.
+///
+/// The instrumentation forwards all calls to a target bus and counts the
+/// transactions, the written and read bytes, the failed transactions and
+/// the time spent on the bus. The counters are kept for each register bank
+/// and, if a table is passed to the constructor, for each high-level
+/// function of the AS1130 class. The duration of all transactions is also
+/// collected in a histogram.
+///
+/// The instrumentation is only compiled if `LRAS1130_INSTRUMENTATION` is
+/// defined. Without it, the library contains no instrumentation code at all.
+///
+/// The time is measured with AS1130Bus::getMicroseconds() of the target bus,
+/// so it also works with AS1130RecordingBus or AS1130Simulator on the host.
+///
+/// The register bank is tracked from the bank selection writes. Writes
+/// which select a bank are counted for the selected bank. Use a separate
+/// instrumentation for each chip.
+///
+/// Example:
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// AS1130Instrumentation::Counters operationCounters[AS1130Instrumentation::OperationCount];
+/// AS1130Instrumentation instrumentation(AS1130WireBus::getDefault(), operationCounters);
+/// AS1130 ledDriver(instrumentation);
+///
+/// void setup() {
+///   ledDriver.setInstrumentation(&instrumentation);
+///   // ...
+///   instrumentation.dump(Serial);
+/// }
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+class AS1130Instrumentation : public AS1130Bus
+{
+public:
+  /// @brief The high-level function which caused a transaction.
+  ///
+  /// Overloaded functions share one value. If a function calls another one,
+  /// all transactions are counted for the outer function.
+  ///
+  enum Operation : uint8_t {
+    OperationOther, ///< Transactions outside of the high-level functions.
+    OperationIsChipConnected, ///< AS1130::isChipConnected()
+    OperationSetRamConfiguration, ///< AS1130::setRamConfiguration()
+    OperationSetOnOffFrame, ///< AS1130::setOnOffFrame()
+    OperationSetOnOffFrame24x5, ///< AS1130::setOnOffFrame24x5()
+    OperationSetOnOffFrame12x11, ///< AS1130::setOnOffFrame12x11()
+    OperationSetOnOffFrameRaw, ///< AS1130::setOnOffFrameRaw()
+    OperationSetOnOffFrameRaw_P, ///< AS1130::setOnOffFrameRaw_P()
+    OperationSetOnOffFrameAllOff, ///< AS1130::setOnOffFrameAllOff()
+    OperationSetOnOffFrameAllOn, ///< AS1130::setOnOffFrameAllOn()
+    OperationSetBlinkAndPwmSetAll, ///< AS1130::setBlinkAndPwmSetAll()
+    OperationSetPwmValue, ///< AS1130::setPwmValue()
+    OperationSetPwmSet, ///< AS1130::setPwmSet()
+    OperationSetPwmSet12x11, ///< AS1130::setPwmSet12x11()
+    OperationSetPwmSet24x5, ///< AS1130::setPwmSet24x5()
+    OperationSetBlinkSet, ///< AS1130::setBlinkSet()
+    OperationSetGrayFrame, ///< AS1130::setGrayFrame()
+    OperationSetDotCorrection, ///< AS1130::setDotCorrection()
+    OperationSetInterruptMask, ///< AS1130::setInterruptMask()
+    OperationSetInterruptFrame, ///< AS1130::setInterruptFrame()
+    OperationSetInterfaceMonitoring, ///< AS1130::setInterfaceMonitoring()
+    OperationSetClockSynchronization, ///< AS1130::setClockSynchronization()
+    OperationSetCurrentSource, ///< AS1130::setCurrentSource()
+    OperationSetScanLimit, ///< AS1130::setScanLimit()
+    OperationSetBlinkEnabled, ///< AS1130::setBlinkEnabled()
+    OperationStartPicture, ///< AS1130::startPicture()
+    OperationStopPicture, ///< AS1130::stopPicture()
+    OperationSetMovieEndFrame, ///< AS1130::setMovieEndFrame()
+    OperationSetMovieFrameCount, ///< AS1130::setMovieFrameCount()
+    OperationSetFrameDelayMs, ///< AS1130::setFrameDelayMs()
+    OperationSetScrollingEnabled, ///< AS1130::setScrollingEnabled()
+    OperationSetScrollingBlockSize, ///< AS1130::setScrollingBlockSize()
+    OperationSetScrollingDirection, ///< AS1130::setScrollingDirection()
+    OperationSetFrameFadingEnabled, ///< AS1130::setFrameFadingEnabled()
+    OperationSetBlinkFrequency, ///< AS1130::setBlinkFrequency()
+    OperationSetMovieLoopCount, ///< AS1130::setMovieLoopCount()
+    OperationStartMovie, ///< AS1130::startMovie()
+    OperationStopMovie, ///< AS1130::stopMovie()
+    OperationSetLowVddResetEnabled, ///< AS1130::setLowVddResetEnabled()
+    OperationSetLowVddStatusEnabled, ///< AS1130::setLowVddStatusEnabled()
+    OperationSetLedErrorCorrectionEnabled, ///< AS1130::setLedErrorCorrectionEnabled()
+    OperationSetDotCorrectionEnabled, ///< AS1130::setDotCorrectionEnabled()
+    OperationSetTestAllLedsEnabled, ///< AS1130::setTestAllLedsEnabled()
+    OperationSetAutomaticTestEnabled, ///< AS1130::setAutomaticTestEnabled()
+    OperationStartChip, ///< AS1130::startChip()
+    OperationStopChip, ///< AS1130::stopChip()
+    OperationResetChip, ///< AS1130::resetChip()
+    OperationRunManualTest, ///< AS1130::runManualTest()
+    OperationGetLedStatus, ///< AS1130::getLedStatus()
+    OperationReadLedStatusMap, ///< AS1130::readLedStatusMap()
+    OperationReadOnOffFrame, ///< AS1130::readOnOffFrame()
+    OperationReadBlinkSet, ///< AS1130::readBlinkSet()
+    OperationReadPwmSet, ///< AS1130::readPwmSet()
+    OperationReadControlRegisters, ///< AS1130::readControlRegisters()
+    OperationIsLedTestRunning, ///< AS1130::isLedTestRunning()
+    OperationIsMovieRunning, ///< AS1130::isMovieRunning()
+    OperationGetDisplayedFrame, ///< AS1130::getDisplayedFrame()
+    OperationGetInterruptStatus, ///< AS1130::getInterruptStatus()
+    OperationReadStatusSnapshot, ///< AS1130::readStatusSnapshot()
+    OperationGetStatusSnapshot, ///< AS1130::getStatusSnapshot()
+    OperationSynchronizeControlRegisterCache, ///< AS1130::synchronizeControlRegisterCache()
+    OperationCount ///< The number of operations.
+  };
+
+  /// @brief The register bank of a transaction.
+  ///
+  enum Bank : uint8_t {
+    BankNone, ///< No or an unknown register bank is selected.
+    BankOnOffFrame, ///< One of the on/off frames.
+    BankBlinkAndPwmSet, ///< One of the blink and PWM sets.
+    BankDotCorrection, ///< The dot correction registers.
+    BankControl, ///< The control registers.
+    BankCount ///< The number of register banks.
+  };
+
+  /// @brief The counters for an operation or register bank.
+  ///
+  struct Counters {
+    uint16_t callCount; ///< The number of calls, only used for operations.
+    uint16_t errorCount; ///< The number of failed transactions, e.g. if the chip did not acknowledge.
+    uint32_t transactionCount; ///< The number of write and read transactions.
+    uint32_t writtenByteCount; ///< The number of written bytes, including the register address.
+    uint32_t readByteCount; ///< The number of received bytes.
+    uint32_t microseconds; ///< The total time spent on the bus.
+  };
+
+  /// @brief Marks the high-level function for all transactions in a scope.
+  ///
+  /// This is used by the AS1130 class. Only the outermost scope is counted.
+  ///
+  class Scope
+  {
+  public:
+    /// @brief Start the scope.
+    ///
+    /// @param instrumentation The instrumentation or `nullptr`.
+    /// @param operation The operation for all transactions in this scope.
+    ///
+    Scope(AS1130Instrumentation *instrumentation, Operation operation);
+
+    /// @brief End the scope.
+    ///
+    ~Scope();
+
+  private:
+    AS1130Instrumentation *_instrumentation; ///< The instrumentation if this is the outermost scope.
+  };
+
+  /// @brief The number of entries in the histogram.
+  ///
+  static const uint8_t cHistogramSize = 8;
+
+public:
+  /// @brief Create a new instrumentation.
+  ///
+  /// @param bus The target bus.
+  /// @param operationCounters A table with OperationCount entries for the
+  ///   counters of each operation, or `nullptr` to count the register banks only.
+  ///
+  explicit AS1130Instrumentation(AS1130Bus &bus, Counters *operationCounters = nullptr);
+
+public:
+  /// @brief Reset all counters.
+  ///
+  void reset();
+
+  /// @brief Get the counters for an operation.
+  ///
+  /// @param operation The operation.
+  /// @return The counters, all zero if there is no table for the operations.
+  ///
+  Counters getOperationCounters(Operation operation) const;
+
+  /// @brief Get the counters for a register bank.
+  ///
+  /// @param bank The register bank.
+  /// @return The counters.
+  ///
+  inline const Counters& getBankCounters(Bank bank) const { return _bankCounters[bank]; }
+
+  /// @brief Get the sum of all counters.
+  ///
+  /// @return The counters for all transactions.
+  ///
+  Counters getTotalCounters() const;
+
+  /// @brief Get the number of transactions in a histogram entry.
+  ///
+  /// @param index The index of the entry, from 0 to cHistogramSize-1.
+  /// @return The number of transactions.
+  ///
+  inline uint32_t getHistogramCount(uint8_t index) const { return _histogram[index]; }
+
+  /// @brief Get the upper limit of a histogram entry.
+  ///
+  /// Entry 0 counts all transactions shorter than 64µs, each following entry
+  /// doubles the limit. The last entry counts all longer transactions.
+  ///
+  /// @param index The index of the entry, from 0 to cHistogramSize-2.
+  /// @return The duration in microseconds.
+  ///
+  static inline uint32_t getHistogramLimit(uint8_t index) { return (static_cast<uint32_t>(64) << index); }
+
+#ifdef ARDUINO
+  /// @brief Write all counters as text.
+  ///
+  /// Only operations and banks with transactions are written, one per line.
+  ///
+  /// @param print The output, e.g. `Serial`.
+  ///
+  void dump(::Print &print) const;
+#else
+  /// @brief Write all counters as text.
+  ///
+  /// Only operations and banks with transactions are written, one per line.
+  ///
+  /// @param file The file to write the counters into.
+  ///
+  void dump(std::FILE *file) const;
+#endif
+
+public: // Implement AS1130Bus
+  virtual void beginTransmission(uint8_t chipAddress) override;
+  virtual bool write(uint8_t data) override;
+  virtual Status endTransmission() override;
+  virtual uint8_t requestFrom(uint8_t chipAddress, uint8_t count) override;
+  virtual uint8_t read() override;
+  virtual uint8_t getBufferSize() const override;
+  virtual void delay(uint16_t milliseconds) override;
+  virtual uint32_t getMicroseconds() const override;
+
+private:
+  /// @brief A function which writes one line of the dump.
+  ///
+  typedef void (*LineWriter)(void *context, const char *line);
+
+  /// @brief Count a transaction.
+  ///
+  /// @param writtenByteCount The number of written bytes.
+  /// @param readByteCount The number of received bytes.
+  /// @param isError True if the transaction failed.
+  /// @param startTime The time when the transaction was started.
+  ///
+  void addTransaction(uint8_t writtenByteCount, uint8_t readByteCount, bool isError, uint32_t startTime);
+
+  /// @brief Write all lines of the dump.
+  ///
+  void writeLines(LineWriter lineWriter, void *context) const;
+
+private:
+  AS1130Bus *_bus; ///< The target bus.
+  Counters *_operationCounters; ///< The table with the operation counters or `nullptr`.
+  Counters _bankCounters[BankCount]; ///< The counters for each register bank.
+  uint32_t _histogram[cHistogramSize]; ///< The number of transactions for each duration range.
+  Operation _operation; ///< The operation of the current scope.
+  Bank _bank; ///< The currently selected register bank.
+  uint8_t _transmissionSize; ///< The number of bytes in the current transmission.
+  uint8_t _firstByte; ///< The first byte of the current transmission.
+  uint8_t _secondByte; ///< The second byte of the current transmission.
+  uint32_t _startTime; ///< The start time of the current transmission.
+};
+
+
+}
+
+
+#endif
+
@@ -0,0 +1,80 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#include "LRAS1130InterruptDispatcher.h"
+
+
+namespace lr {
+
+
+AS1130InterruptDispatcher::AS1130InterruptDispatcher(AS1130 &chip)
+  : _chip(&chip),
+    _isSignalled(false)
+{
+  for (uint8_t i = 0; i < cFlagCount; ++i) {
+    _handlers[i] = nullptr;
+    _contexts[i] = nullptr;
+  }
+}
+
+
+void AS1130InterruptDispatcher::setHandler(AS1130::InterruptMaskFlag flag, Handler handler, void *context)
+{
+  for (uint8_t i = 0; i < cFlagCount; ++i) {
+    if ((flag & (1<<i)) != 0) {
+      _handlers[i] = handler;
+      _contexts[i] = context;
+    }
+  }
+}
+
+
+void AS1130InterruptDispatcher::begin()
+{
+  uint8_t mask = 0;
+  for (uint8_t i = 0; i < cFlagCount; ++i) {
+    if (_handlers[i] != nullptr) {
+      mask |= (1<<i);
+    }
+  }
+  _chip->setInterruptMask(mask);
+  _chip->getInterruptStatus();
+  _isSignalled = false;
+}
+
+
+uint8_t AS1130InterruptDispatcher::process()
+{
+  if (!_isSignalled) {
+    return 0;
+  }
+  _isSignalled = false;
+  // Reading the status clears the interrupt and releases the IRQ pin.
+  const uint8_t interruptStatus = _chip->getInterruptStatus();
+  for (uint8_t i = 0; i < cFlagCount; ++i) {
+    if ((interruptStatus & (1<<i)) != 0 && _handlers[i] != nullptr) {
+      _handlers[i](_contexts[i], interruptStatus);
+    }
+  }
+  return interruptStatus;
+}
+
+
+}
+
+
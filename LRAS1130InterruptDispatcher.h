@@ -0,0 +1,123 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#pragma once
+
+
+#include "LRAS1130.h"
+
+
+namespace lr {
+
+
+/// @brief A dispatcher for the interrupts of the chip.
+///
+/// Register a handler for each interrupt flag you are interested in, then
+/// call begin() to set the interrupt mask of the chip. Connect the IRQ pin
+/// of the chip to an interrupt capable pin and call signal() from the
+/// interrupt service routine. process() reads the interrupt status once
+/// for each signalled interrupt and calls the matching handlers. If no
+/// interrupt was signalled, process() does not access the bus.
+///
+/// Example:
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// AS1130InterruptDispatcher dispatcher(ledDriver);
+///
+/// void onIrq() {
+///   dispatcher.signal();
+/// }
+///
+/// void onMovieFinished(void *context, uint8_t interruptStatus) {
+///   // ...
+/// }
+///
+/// void setup() {
+///   // ...
+///   dispatcher.setHandler(AS1130::IMF_MovieFinished, onMovieFinished, nullptr);
+///   dispatcher.begin();
+///   attachInterrupt(digitalPinToInterrupt(2), onIrq, FALLING);
+/// }
+///
+/// void loop() {
+///   dispatcher.process();
+/// }
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+class AS1130InterruptDispatcher
+{
+public:
+  /// @brief The handler for an interrupt.
+  ///
+  /// @param context The context passed to setHandler().
+  /// @param interruptStatus All flags of the interrupt status register.
+  ///
+  typedef void (*Handler)(void *context, uint8_t interruptStatus);
+
+  /// @brief The number of interrupt flags.
+  ///
+  static const uint8_t cFlagCount = 8;
+
+public:
+  /// @brief Create a new dispatcher for a chip.
+  ///
+  /// @param chip The chip to use.
+  ///
+  AS1130InterruptDispatcher(AS1130 &chip);
+
+public:
+  /// @brief Set the handler for an interrupt flag.
+  ///
+  /// @param flag One of the flags from AS1130::InterruptMaskFlag.
+  /// @param handler The handler to call, or `nullptr` to remove the handler.
+  /// @param context A pointer passed to the handler.
+  ///
+  void setHandler(AS1130::InterruptMaskFlag flag, Handler handler, void *context);
+
+  /// @brief Write the interrupt mask for all registered handlers to the chip.
+  ///
+  /// This also reads the interrupt status once, to clear pending interrupts.
+  ///
+  void begin();
+
+  /// @brief Signal an interrupt.
+  ///
+  /// This function does not access the bus and can be called from an
+  /// interrupt service routine.
+  ///
+  inline void signal() { _isSignalled = true; }
+
+  /// @brief Process a signalled interrupt.
+  ///
+  /// If an interrupt was signalled, the interrupt status is read from the
+  /// chip and the handlers for all set flags are called.
+  ///
+  /// @return The interrupt status, or zero if no interrupt was signalled.
+  ///
+  uint8_t process();
+
+private:
+  AS1130 *_chip; ///< The chip.
+  volatile bool _isSignalled; ///< If an interrupt was signalled.
+  Handler _handlers[cFlagCount]; ///< The handler for each flag.
+  void *_contexts[cFlagCount]; ///< The context for each handler.
+};
+
+
+}
+
+
@@ -0,0 +1,234 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#include "LRAS1130MoviePlanner.h"
+
+
+#ifdef ARDUINO_ARCH_AVR
+#include <avr/pgmspace.h>
+// Make it compatible with the standart
+#include <string.h>
+namespace std { using ::memcmp; }
+#else
+#include <cstring>
+#endif
+
+
+namespace lr {
+
+
+AS1130MoviePlanner::AS1130MoviePlanner(uint8_t *sequenceBuffer, uint16_t sequenceSize, bool isProgramMemory)
+  : _sequence(sequenceBuffer),
+    _sequenceSize(sequenceSize),
+    _sequenceLength(0),
+    _isProgramMemory(isProgramMemory),
+    _isDotCorrectionUsed(false),
+    _frameCount(0),
+    _pwmSetCount(0)
+{
+}
+
+
+void AS1130MoviePlanner::clear()
+{
+  _sequenceLength = 0;
+  _frameCount = 0;
+  _pwmSetCount = 0;
+}
+
+
+void AS1130MoviePlanner::setDotCorrectionUsed(bool used)
+{
+  _isDotCorrectionUsed = used;
+}
+
+
+bool AS1130MoviePlanner::addFrame(const AS1130FrameData *frameData, const uint8_t *pwmData)
+{
+  if (_sequenceLength >= _sequenceSize) {
+    return false;
+  }
+  const uint8_t pwmSetIndex = findPwmSet(pwmData);
+  if (pwmSetIndex >= cMaximumPwmSetCount) {
+    return false;
+  }
+  // Search for an identical frame.
+  uint8_t registerData[AS1130FrameData::cSize];
+  readFrame(frameData, pwmSetIndex, registerData);
+  uint8_t frameIndex = 0;
+  for (; frameIndex < _frameCount; ++frameIndex) {
+    uint8_t existingData[AS1130FrameData::cSize];
+    readFrame(_frames[frameIndex], _framePwmSets[frameIndex], existingData);
+    if (std::memcmp(registerData, existingData, AS1130FrameData::cSize) == 0) {
+      break;
+    }
+  }
+  // Check if the new frame and PWM set still fit on the chip.
+  const uint8_t frameCount = _frameCount + (frameIndex == _frameCount ? 1 : 0);
+  const uint8_t pwmSetCount = _pwmSetCount + (pwmSetIndex == _pwmSetCount ? 1 : 0);
+  if (frameCount > getAvailableFrameCount(pwmSetCount)) {
+    return false;
+  }
+  if (pwmSetIndex == _pwmSetCount) {
+    _pwmSets[pwmSetIndex] = pwmData;
+    ++_pwmSetCount;
+  } else if (_pwmSets[pwmSetIndex] == nullptr) {
+    // Replace the placeholder of frames without PWM data.
+    _pwmSets[pwmSetIndex] = pwmData;
+  }
+  if (frameIndex == _frameCount) {
+    _frames[frameIndex] = frameData;
+    _framePwmSets[frameIndex] = pwmSetIndex;
+    ++_frameCount;
+  }
+  _sequence[_sequenceLength] = frameIndex;
+  ++_sequenceLength;
+  return true;
+}
+
+
+AS1130::RamConfiguration AS1130MoviePlanner::getRamConfiguration() const
+{
+  if (_pwmSetCount <= 1) {
+    return AS1130::RamConfiguration1;
+  }
+  return static_cast<AS1130::RamConfiguration>(_pwmSetCount);
+}
+
+
+uint8_t AS1130MoviePlanner::getAvailableFrameCount() const
+{
+  return getAvailableFrameCount(_pwmSetCount);
+}
+
+
+uint8_t AS1130MoviePlanner::getMovieFrameCount() const
+{
+  if (_sequenceLength < 2 || _frameCount < 2 || (_sequenceLength % _frameCount) != 0) {
+    return 0;
+  }
+  for (uint16_t step = 0; step < _sequenceLength; ++step) {
+    if (_sequence[step] != (step % _frameCount)) {
+      return 0;
+    }
+  }
+  return _frameCount;
+}
+
+
+uint16_t AS1130MoviePlanner::getMovieLoopCount() const
+{
+  const uint8_t movieFrameCount = getMovieFrameCount();
+  if (movieFrameCount == 0) {
+    return 0;
+  }
+  return _sequenceLength / movieFrameCount;
+}
+
+
+void AS1130MoviePlanner::upload(AS1130 &chip) const
+{
+  chip.setRamConfiguration(getRamConfiguration());
+  for (uint8_t setIndex = 0; setIndex < _pwmSetCount; ++setIndex) {
+    const uint8_t *pwmData = _pwmSets[setIndex];
+    if (pwmData == nullptr) {
+      continue;
+    }
+#ifdef ARDUINO_ARCH_AVR
+    if (_isProgramMemory) {
+      uint8_t buffer[AS1130::cPwmDataSize];
+      for (uint8_t i = 0; i < AS1130::cPwmDataSize; ++i) {
+        buffer[i] = pgm_read_byte(pwmData + i);
+      }
+      chip.setPwmSet(setIndex, buffer);
+      continue;
+    }
+#endif
+    chip.setPwmSet(setIndex, pwmData);
+  }
+  for (uint8_t frameIndex = 0; frameIndex < _frameCount; ++frameIndex) {
+    AS1130FrameData frameData;
+    readFrame(_frames[frameIndex], _framePwmSets[frameIndex], frameData.registers);
+    chip.setOnOffFrameRaw(frameIndex, frameData);
+  }
+}
+
+
+uint8_t AS1130MoviePlanner::getAvailableFrameCount(uint8_t pwmSetCount) const
+{
+  if (pwmSetCount == 0) {
+    pwmSetCount = 1;
+  }
+  uint8_t frameCount = cMaximumFrameCount - (pwmSetCount - 1) * 6;
+  if (_isDotCorrectionUsed) {
+    --frameCount;
+  }
+  return frameCount;
+}
+
+
+uint8_t AS1130MoviePlanner::findPwmSet(const uint8_t *pwmData) const
+{
+  if (pwmData == nullptr || (_pwmSetCount > 0 && _pwmSets[0] == nullptr)) {
+    // Frames without PWM data use the first set.
+    return 0;
+  }
+  for (uint8_t setIndex = 0; setIndex < _pwmSetCount; ++setIndex) {
+    const uint8_t *existingData = _pwmSets[setIndex];
+    if (existingData == pwmData || isDataEqual(existingData, pwmData, AS1130::cPwmDataSize)) {
+      return setIndex;
+    }
+  }
+  return _pwmSetCount;
+}
+
+
+uint8_t AS1130MoviePlanner::readByte(const uint8_t *data, uint8_t index) const
+{
+#ifdef ARDUINO_ARCH_AVR
+  if (_isProgramMemory) {
+    return pgm_read_byte(data + index);
+  }
+#endif
+  return data[index];
+}
+
+
+bool AS1130MoviePlanner::isDataEqual(const uint8_t *a, const uint8_t *b, uint8_t size) const
+{
+  for (uint8_t i = 0; i < size; ++i) {
+    if (readByte(a, i) != readByte(b, i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+void AS1130MoviePlanner::readFrame(const AS1130FrameData *frameData, uint8_t pwmSetIndex, uint8_t *registerData) const
+{
+  for (uint8_t i = 0; i < AS1130FrameData::cSize; ++i) {
+    registerData[i] = readByte(frameData->registers, i);
+  }
+  registerData[1] = (registerData[1] & 0x1f) | (pwmSetIndex<<5);
+}
+
+
+}
+
+
@@ -0,0 +1,200 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#pragma once
+
+
+#include "LRAS1130.h"
+
+
+namespace lr {
+
+
+/// @brief A planner to fit a sequence of frames into the memory of the chip.
+///
+/// Add the frames of a sequence using addFrame(), together with the PWM values
+/// each frame requires. The planner removes duplicate frames and PWM sets,
+/// assigns frame and set indexes and selects the RAM configuration which
+/// provides the most on/off frames for the required number of PWM sets.
+/// upload() writes the plan to the chip, using one block write for each
+/// frame and PWM set.
+///
+/// The planner keeps pointers to the frame and PWM data, it has to exist
+/// until the plan is uploaded. Therefore both are passed as pointers, never
+/// pass the address of a temporary or of a variable inside a loop.
+///
+/// Example:
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// uint8_t sequence[100];
+/// AS1130MoviePlanner planner(sequence, 100);
+/// for (uint8_t i = 0; i < 100; ++i) {
+///   planner.addFrame(&frames[i], pwmSets[i]);
+/// }
+/// planner.upload(ledDriver);
+/// if (planner.getMovieFrameCount() > 0) {
+///   ledDriver.setMovieFrameCount(planner.getMovieFrameCount());
+///   ledDriver.startMovie(0);
+/// }
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+class AS1130MoviePlanner
+{
+public:
+  /// @brief The maximum number of on/off frames on the chip.
+  ///
+  static const uint8_t cMaximumFrameCount = 36;
+
+  /// @brief The maximum number of blink&PWM sets on the chip.
+  ///
+  static const uint8_t cMaximumPwmSetCount = 6;
+
+public:
+  /// @brief Create a new planner.
+  ///
+  /// @param sequenceBuffer A buffer which receives the frame index for each step of the sequence.
+  /// @param sequenceSize The size of the sequence buffer. This limits the number of added frames.
+  /// @param isProgramMemory True if all frame and PWM data is stored in program memory.
+  ///   This is only used on AVR platforms.
+  ///
+  AS1130MoviePlanner(uint8_t *sequenceBuffer, uint16_t sequenceSize, bool isProgramMemory = false);
+
+public:
+  /// @brief Remove all frames from the plan.
+  ///
+  void clear();
+
+  /// @brief Set if the dot correction is used.
+  ///
+  /// The dot correction data uses the memory of one on/off frame.
+  ///
+  /// @param used True if the dot correction is used.
+  ///
+  void setDotCorrectionUsed(bool used);
+
+  /// @brief Add the next frame of the sequence.
+  ///
+  /// The PWM set index in the frame data is ignored and replaced by the assigned set.
+  ///
+  /// @param frameData A pointer to the register data of the frame. The data
+  ///   has to exist until the plan is uploaded.
+  /// @param pwmData The cPwmDataSize (132) PWM values required by the frame, in the
+  ///   order of the chip. If this is `nullptr`, the frame does not depend on the PWM
+  ///   values and uses the first PWM set.
+  /// @return `true` if the frame was added, `false` if the frame does not fit on
+  ///   the chip or into the sequence buffer. In this case the plan is not changed.
+  ///
+  bool addFrame(const AS1130FrameData *frameData, const uint8_t *pwmData = nullptr);
+
+  /// @brief Get the RAM configuration for the plan.
+  ///
+  AS1130::RamConfiguration getRamConfiguration() const;
+
+  /// @brief Get the number of on/off frames available with the selected RAM configuration.
+  ///
+  uint8_t getAvailableFrameCount() const;
+
+  /// @brief Get the number of unique frames in the plan.
+  ///
+  inline uint8_t getFrameCount() const { return _frameCount; }
+
+  /// @brief Get the number of unique PWM sets in the plan.
+  ///
+  inline uint8_t getPwmSetCount() const { return _pwmSetCount; }
+
+  /// @brief Get the number of steps in the sequence.
+  ///
+  inline uint16_t getSequenceLength() const { return _sequenceLength; }
+
+  /// @brief Get the frame index for a step of the sequence.
+  ///
+  /// @param step The step of the sequence.
+  /// @return The index of the on/off frame on the chip.
+  ///
+  inline uint8_t getSequenceFrameIndex(uint16_t step) const { return _sequence[step]; }
+
+  /// @brief Get the PWM set index assigned to a frame.
+  ///
+  /// @param frameIndex The index of the on/off frame.
+  /// @return The index of the blink&PWM set.
+  ///
+  inline uint8_t getFramePwmSetIndex(uint8_t frameIndex) const { return _framePwmSets[frameIndex]; }
+
+  /// @brief Get the number of frames if the sequence can be played as movie.
+  ///
+  /// The sequence can be played as movie starting at frame 0, if it repeats
+  /// the frames 0 to n-1 in order.
+  ///
+  /// @return The number of movie frames, or zero if the sequence is no movie.
+  ///
+  uint8_t getMovieFrameCount() const;
+
+  /// @brief Get the number of loops if the sequence is played as movie.
+  ///
+  /// @return The number of times the movie frames are repeated in the sequence.
+  ///
+  uint16_t getMovieLoopCount() const;
+
+  /// @brief Write the plan to the chip.
+  ///
+  /// This sets the RAM configuration, writes all PWM sets and all frames.
+  /// If a frame shadow is set for the chip, unchanged frames are not sent again.
+  ///
+  /// @param chip The chip to write to.
+  ///
+  void upload(AS1130 &chip) const;
+
+private:
+  /// @brief Get the number of available frames for a number of PWM sets.
+  ///
+  uint8_t getAvailableFrameCount(uint8_t pwmSetCount) const;
+
+  /// @brief Find the index for a PWM set.
+  ///
+  /// @return The index of an identical set, or the index for a new set.
+  ///
+  uint8_t findPwmSet(const uint8_t *pwmData) const;
+
+  /// @brief Read a byte of frame or PWM data.
+  ///
+  uint8_t readByte(const uint8_t *data, uint8_t index) const;
+
+  /// @brief Compare two blocks of frame or PWM data.
+  ///
+  bool isDataEqual(const uint8_t *a, const uint8_t *b, uint8_t size) const;
+
+  /// @brief Read the frame data with the assigned PWM set index.
+  ///
+  void readFrame(const AS1130FrameData *frameData, uint8_t pwmSetIndex, uint8_t *registerData) const;
+
+private:
+  uint8_t *_sequence; ///< The frame index for each step of the sequence.
+  uint16_t _sequenceSize; ///< The size of the sequence buffer.
+  uint16_t _sequenceLength; ///< The number of steps in the sequence.
+  bool _isProgramMemory; ///< If the data is stored in program memory.
+  bool _isDotCorrectionUsed; ///< If the dot correction is used.
+  uint8_t _frameCount; ///< The number of unique frames.
+  uint8_t _pwmSetCount; ///< The number of unique PWM sets.
+  const AS1130FrameData *_frames[cMaximumFrameCount]; ///< The unique frames.
+  uint8_t _framePwmSets[cMaximumFrameCount]; ///< The PWM set for each unique frame.
+  const uint8_t *_pwmSets[cMaximumPwmSetCount]; ///< The unique PWM sets.
+};
+
+
+}
+
+
@@ -19,10 +19,8 @@
 #include "LRAS1130.h"
 
 
-#include <Arduino.h>
-
-
 #ifdef ARDUINO_ARCH_AVR
+#include <avr/pgmspace.h>
 // Make it compatible with the standart
 #include <string.h>
 namespace std { using ::memset; } 
@@ -35,6 +33,44 @@ namespace std { using ::memcpy; }
 namespace lr {
 
 
+namespace {
+
+
+#ifdef ARDUINO_ARCH_AVR
+/// The bits of a nibble spread into the lowest bit of four bytes.
+///
+/// The highest bit of the nibble (the leftmost pixel) is moved into the lowest byte.
+///
+const uint32_t cSpreadNibbleTable[16] PROGMEM = {
+  0x00000000, 0x01000000, 0x00010000, 0x01010000,
+  0x00000100, 0x01000100, 0x00010100, 0x01010100,
+  0x00000001, 0x01000001, 0x00010001, 0x01010001,
+  0x00000101, 0x01000101, 0x00010101, 0x01010101
+};
+#endif
+
+
+/// Spread the bits of a nibble into the lowest bit of four bytes.
+///
+/// @param nibble The nibble with the bits of four pixels, the leftmost pixel in the highest bit.
+/// @return A word with one byte for each pixel, the leftmost pixel in the lowest byte.
+///
+inline uint32_t spreadNibble(uint8_t nibble)
+{
+#ifdef ARDUINO_ARCH_AVR
+  return pgm_read_dword(&cSpreadNibbleTable[nibble]);
+#else
+  return (static_cast<uint32_t>(nibble & 0b1000) >> 3)
+    | (static_cast<uint32_t>(nibble & 0b0100) << 6)
+    | (static_cast<uint32_t>(nibble & 0b0010) << 15)
+    | (static_cast<uint32_t>(nibble & 0b0001) << 24);
+#endif
+}
+
+
+}
+
+
 AS1130Picture12x11::AS1130Picture12x11()
 {
   std::memset(_data, 0, getDataByteCount());
@@ -73,12 +109,35 @@ bool AS1130Picture12x11::getPixel(uint8_t x, uint8_t y)
 
 void AS1130Picture12x11::writeRegisters(uint8_t *registerData, const uint8_t *rawData, uint8_t pwmSetIndex)
 {
-  std::memset(registerData, 0, 0x18);
-  for (uint8_t x = 0; x < getWidth(); ++x) {
-    for (uint8_t y = 0; y < getHeight(); ++y) {
-      if ((rawData[getDataIndex(x, y)] & getDataBit(x,y)) != 0) {
-        registerData[(x*2)+(y/8)] |= (1<<(x&7));
+  // The raw data is a stream of 33 nibbles, three nibbles for each row.
+  // The rows are collected from the bottom to the top, so after shifting
+  // each column of a nibble ends up in its own byte of the accumulator.
+  uint32_t lowRows[3] = {0, 0, 0}; // Rows 0-7, one byte per column.
+  uint32_t highRows[3] = {0, 0, 0}; // Rows 8-10, one byte per column.
+  uint8_t nibbleIndex = 33;
+  for (uint8_t y = getHeight(); y > 0;) {
+    --y;
+    uint32_t *rows = (y >= 8 ? highRows : lowRows);
+    for (uint8_t column = 3; column > 0;) {
+      --column;
+      --nibbleIndex;
+      uint8_t nibble = rawData[nibbleIndex>>1];
+      if ((nibbleIndex & 1) == 0) {
+        nibble >>= 4;
       }
+      rows[column] = (rows[column]<<1) | spreadNibble(nibble & 0x0f);
+    }
+  }
+  // Write the collected bytes into the segment registers.
+  for (uint8_t column = 0; column < 3; ++column) {
+    uint32_t low = lowRows[column];
+    uint32_t high = highRows[column];
+    uint8_t *segmentData = registerData + (column * 8);
+    for (uint8_t i = 0; i < 4; ++i) {
+      segmentData[i*2] = static_cast<uint8_t>(low);
+      segmentData[i*2+1] = static_cast<uint8_t>(high);
+      low >>= 8;
+      high >>= 8;
     }
   }
   registerData[1] |= (pwmSetIndex<<5);
@@ -19,9 +19,6 @@
 #include "LRAS1130.h"
 
 
-#include <Arduino.h>
-
-
 #ifdef ARDUINO_ARCH_AVR
 // Make it compatible with the standart
 #include <string.h>
@@ -73,17 +70,31 @@ bool AS1130Picture24x5::getPixel(uint8_t x, uint8_t y)
 
 void AS1130Picture24x5::writeRegisters(uint8_t *registerData, const uint8_t *rawData, uint8_t pwmSetIndex)
 {
+  // Each segment displays two columns with 5 LEDs. The bits of the left
+  // column are collected in the first and the bits of the right column in
+  // the second register byte of each segment. The rows are read from the
+  // bottom to the top, so the top row ends up in the lowest bit.
   std::memset(registerData, 0, 0x18);
-  for (uint8_t x = 0; x < getWidth(); ++x) {
-    for (uint8_t y = 0; y < getHeight(); ++y) {
-      if ((rawData[getDataIndex(x, y)] & getDataBit(x,y)) != 0) {
-        const uint8_t ledIndex = (x*5+y);
-        const uint8_t registerBitIndex = ledIndex%10;
-        uint8_t registerIndex = (ledIndex/10)*2+(registerBitIndex/8);
-        registerData[registerIndex] |= (1<<(registerBitIndex&7));
+  const uint8_t *data = rawData + getDataByteCount();
+  for (uint8_t y = 0; y < getHeight(); ++y) {
+    uint8_t *segmentData = registerData + 0x18;
+    for (uint8_t i = 0; i < 3; ++i) {
+      --data;
+      uint8_t bits = *data;
+      for (uint8_t pair = 0; pair < 4; ++pair) {
+        segmentData -= 2;
+        segmentData[0] = (segmentData[0]<<1) | ((bits>>1)&1);
+        segmentData[1] = (segmentData[1]<<1) | (bits&1);
+        bits >>= 2;
       }
     }
   }
+  // Combine both columns into the 10 bits of each segment.
+  for (uint8_t i = 0; i < 0x18; i += 2) {
+    const uint8_t rightColumn = registerData[i+1];
+    registerData[i] |= (rightColumn<<5);
+    registerData[i+1] = (rightColumn>>3);
+  }
   registerData[1] |= (pwmSetIndex<<5);
 }
 
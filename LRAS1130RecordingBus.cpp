@@ -0,0 +1,208 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#ifndef ARDUINO
+#include "LRAS1130RecordingBus.h"
+
+
+namespace lr {
+
+
+AS1130RecordingBus::AS1130RecordingBus(AS1130Bus *target, uint8_t bufferSize)
+  : _target(target), _bufferSize(bufferSize), _transactions(), _currentWrite(), _readPosition(0), _delayTime(0)
+{
+}
+
+
+void AS1130RecordingBus::setTarget(AS1130Bus *target)
+{
+  _target = target;
+}
+
+
+void AS1130RecordingBus::setBufferSize(uint8_t bufferSize)
+{
+  _bufferSize = bufferSize;
+}
+
+
+void AS1130RecordingBus::clear()
+{
+  _transactions.clear();
+  _delayTime = 0;
+}
+
+
+std::size_t AS1130RecordingBus::getWrittenByteCount() const
+{
+  std::size_t count = 0;
+  for (const Transaction &transaction : _transactions) {
+    if (transaction.type == TransactionWrite) {
+      count += transaction.data.size();
+    }
+  }
+  return count;
+}
+
+
+std::size_t AS1130RecordingBus::getReadByteCount() const
+{
+  std::size_t count = 0;
+  for (const Transaction &transaction : _transactions) {
+    if (transaction.type == TransactionRead) {
+      count += transaction.data.size();
+    }
+  }
+  return count;
+}
+
+
+std::size_t AS1130RecordingBus::getWireByteCount() const
+{
+  std::size_t count = 0;
+  for (const Transaction &transaction : _transactions) {
+    count += transaction.data.size() + 1;
+  }
+  return count;
+}
+
+
+std::size_t AS1130RecordingBus::getFailedTransactionCount() const
+{
+  std::size_t count = 0;
+  for (const Transaction &transaction : _transactions) {
+    if (transaction.status != StatusSuccess) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+
+void AS1130RecordingBus::writeLog(std::FILE *file) const
+{
+  for (const Transaction &transaction : _transactions) {
+    std::fprintf(file, "%c %02x:", (transaction.type == TransactionWrite ? 'W' : 'R'), transaction.chipAddress);
+    for (uint8_t data : transaction.data) {
+      std::fprintf(file, " %02x", data);
+    }
+    std::fprintf(file, " [%d]\n", transaction.status);
+  }
+}
+
+
+void AS1130RecordingBus::beginTransmission(uint8_t chipAddress)
+{
+  _currentWrite.type = TransactionWrite;
+  _currentWrite.chipAddress = chipAddress;
+  _currentWrite.status = StatusSuccess;
+  _currentWrite.data.clear();
+  if (_target != nullptr) {
+    _target->beginTransmission(chipAddress);
+  }
+}
+
+
+bool AS1130RecordingBus::write(uint8_t data)
+{
+  if (_currentWrite.data.size() >= _bufferSize) {
+    return false;
+  }
+  if (_target != nullptr && !_target->write(data)) {
+    return false;
+  }
+  _currentWrite.data.push_back(data);
+  return true;
+}
+
+
+AS1130Bus::Status AS1130RecordingBus::endTransmission()
+{
+  if (_target != nullptr) {
+    _currentWrite.status = _target->endTransmission();
+  }
+  _transactions.push_back(_currentWrite);
+  return _currentWrite.status;
+}
+
+
+uint8_t AS1130RecordingBus::requestFrom(uint8_t chipAddress, uint8_t count)
+{
+  Transaction transaction;
+  transaction.type = TransactionRead;
+  transaction.chipAddress = chipAddress;
+  transaction.status = StatusSuccess;
+  if (_target != nullptr) {
+    const uint8_t receivedCount = _target->requestFrom(chipAddress, count);
+    for (uint8_t i = 0; i < receivedCount; ++i) {
+      transaction.data.push_back(_target->read());
+    }
+    if (receivedCount != count) {
+      transaction.status = StatusAddressNack;
+    }
+  } else {
+    transaction.data.assign(count, 0x00);
+  }
+  _transactions.push_back(transaction);
+  _readPosition = 0;
+  return static_cast<uint8_t>(transaction.data.size());
+}
+
+
+uint8_t AS1130RecordingBus::read()
+{
+  if (_transactions.empty()) {
+    return 0x00;
+  }
+  const std::vector<uint8_t> &data = _transactions.back().data;
+  if (_readPosition < data.size()) {
+    return data[_readPosition++];
+  }
+  return 0x00;
+}
+
+
+uint8_t AS1130RecordingBus::getBufferSize() const
+{
+  return _bufferSize;
+}
+
+
+void AS1130RecordingBus::delay(uint16_t milliseconds)
+{
+  _delayTime += milliseconds;
+  if (_target != nullptr) {
+    _target->delay(milliseconds);
+  }
+}
+
+
+uint32_t AS1130RecordingBus::getMicroseconds() const
+{
+  if (_target != nullptr) {
+    return _target->getMicroseconds();
+  }
+  // Without target, only the delays are counted as time.
+  return _delayTime * 1000;
+}
+
+
+}
+
+
+#endif
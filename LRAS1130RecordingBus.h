@@ -0,0 +1,166 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#pragma once
+#ifndef ARDUINO
+
+
+#include "LRAS1130Bus.h"
+
+#include <cinttypes>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+
+namespace lr {
+
+
+/// @brief A bus for host builds which records every transaction.
+///
+/// This bus is used to measure the communication of the library on a
+/// regular computer. Every transmission and every read request is stored as
+/// one transaction. The recorded data can be analysed or written into a log.
+///
+/// If a target bus is set, all calls are forwarded to it, e.g. to a simulated
+/// chip. Without target, all writes succeed and all read bytes are zero.
+///
+class AS1130RecordingBus : public AS1130Bus
+{
+public:
+  /// @brief The type of a transaction.
+  ///
+  enum TransactionType : uint8_t {
+    TransactionWrite, ///< A write transmission.
+    TransactionRead ///< A read request.
+  };
+
+  /// @brief One recorded transaction.
+  ///
+  struct Transaction {
+    TransactionType type; ///< The type of the transaction.
+    uint8_t chipAddress; ///< The addressed chip.
+    Status status; ///< The status of the transaction.
+    std::vector<uint8_t> data; ///< The written or read bytes.
+  };
+
+  /// @brief The list of recorded transactions.
+  ///
+  typedef std::vector<Transaction> TransactionList;
+
+public:
+  /// @brief Create a new recording bus.
+  ///
+  /// @param target The bus to forward all calls, or `nullptr` for no target.
+  /// @param bufferSize The size of the transmit buffer in bytes.
+  ///
+  explicit AS1130RecordingBus(AS1130Bus *target = nullptr, uint8_t bufferSize = 32);
+
+public:
+  /// @brief Set the target bus.
+  ///
+  /// @param target The bus to forward all calls, or `nullptr` for no target.
+  ///
+  void setTarget(AS1130Bus *target);
+
+  /// @brief Set the size of the transmit buffer.
+  ///
+  /// @param bufferSize The size of the transmit buffer in bytes, including the register address.
+  ///
+  void setBufferSize(uint8_t bufferSize);
+
+  /// @brief Remove all recorded transactions and reset the counters.
+  ///
+  void clear();
+
+  /// @brief Access the recorded transactions.
+  ///
+  /// @return A list with all recorded transactions.
+  ///
+  inline const TransactionList& getTransactions() const { return _transactions; }
+
+  /// @brief Get the number of recorded transactions.
+  ///
+  /// @return The number of write and read transactions.
+  ///
+  inline std::size_t getTransactionCount() const { return _transactions.size(); }
+
+  /// @brief Get the number of written data bytes.
+  ///
+  /// @return The number of data bytes in all write transactions.
+  ///
+  std::size_t getWrittenByteCount() const;
+
+  /// @brief Get the number of read data bytes.
+  ///
+  /// @return The number of data bytes received in all read transactions.
+  ///
+  std::size_t getReadByteCount() const;
+
+  /// @brief Get the number of bytes on the wire.
+  ///
+  /// This counts all data bytes plus the address byte of each transaction.
+  ///
+  /// @return The total number of bytes on the wire.
+  ///
+  std::size_t getWireByteCount() const;
+
+  /// @brief Get the number of transactions which failed.
+  ///
+  /// @return The number of transactions with a status other than StatusSuccess.
+  ///
+  std::size_t getFailedTransactionCount() const;
+
+  /// @brief Get the total time passed to delay().
+  ///
+  /// @return The time in milliseconds.
+  ///
+  inline uint32_t getDelayTime() const { return _delayTime; }
+
+  /// @brief Write all recorded transactions as text.
+  ///
+  /// Each transaction is written as one line, e.g. `W 30: fd 01 [0]`.
+  ///
+  /// @param file The file to write the log into.
+  ///
+  void writeLog(std::FILE *file) const;
+
+public: // Implement AS1130Bus
+  virtual void beginTransmission(uint8_t chipAddress) override;
+  virtual bool write(uint8_t data) override;
+  virtual Status endTransmission() override;
+  virtual uint8_t requestFrom(uint8_t chipAddress, uint8_t count) override;
+  virtual uint8_t read() override;
+  virtual uint8_t getBufferSize() const override;
+  virtual void delay(uint16_t milliseconds) override;
+  virtual uint32_t getMicroseconds() const override;
+
+private:
+  AS1130Bus *_target; ///< The target bus or `nullptr`.
+  uint8_t _bufferSize; ///< The size of the transmit buffer.
+  TransactionList _transactions; ///< The recorded transactions.
+  Transaction _currentWrite; ///< The transmission which is currently built.
+  std::size_t _readPosition; ///< The read position in the last read transaction.
+  uint32_t _delayTime; ///< The total time passed to delay().
+};
+
+
+}
+
+
+#endif
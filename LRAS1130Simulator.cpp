@@ -0,0 +1,730 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#ifndef ARDUINO
+#include "LRAS1130Simulator.h"
+
+
+#include "LRAS1130.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace lr {
+
+
+namespace {
+
+
+/// The address for the register selection.
+///
+const uint8_t cRegisterSelectionAddress = 0xfd;
+
+/// The duration of one frame delay step with the 1 MHz clock in microseconds.
+///
+const uint64_t cFrameDelayUnit = 32500;
+
+/// The duration of a LED test with the 1 MHz clock in microseconds.
+///
+const uint64_t cLedTestDuration = 32500;
+
+/// The blink period with the 1 MHz clock in microseconds.
+///
+const uint64_t cBlinkPeriod = 1500000;
+
+
+}
+
+
+AS1130Simulator::AS1130Simulator(uint8_t chipAddress)
+  : _chipAddress(chipAddress),
+    _bufferSize(32),
+    _busFrequency(100000),
+    _frameHandler()
+{
+  std::memset(_connectedLeds, 0xff, cFrameSize);
+  reset();
+}
+
+
+void AS1130Simulator::reset()
+{
+  _writeAddress = 0;
+  _writeCount = 0;
+  _isFirstByte = true;
+  _isRegisterSelection = false;
+  _isDisplayChanged = false;
+  _registerSelection = AS1130::RS_NOP;
+  _address = 0;
+  _readCount = 0;
+  _time = 0;
+  _frameCounter = 0;
+  std::memset(_frames, 0, sizeof(_frames));
+  std::memset(_blinkAndPwmSets, 0, sizeof(_blinkAndPwmSets));
+  std::memset(_dotCorrection, 0, sizeof(_dotCorrection));
+  resetControl();
+}
+
+
+void AS1130Simulator::advanceTime(uint64_t microseconds)
+{
+  const uint64_t targetTime = _time + microseconds;
+  while (true) {
+    uint64_t nextEventTime = targetTime;
+    if (_mode == ModeMovie && _nextStepTime < nextEventTime) {
+      nextEventTime = _nextStepTime;
+    }
+    if (_testEndTime != 0 && _testEndTime < nextEventTime) {
+      nextEventTime = _testEndTime;
+    }
+    _time = nextEventTime;
+    if (_time >= targetTime) {
+      break;
+    }
+    if (_testEndTime != 0 && _testEndTime == _time) {
+      finishLedTest();
+    }
+    if (_mode == ModeMovie && _nextStepTime == _time) {
+      stepMovie();
+    }
+  }
+}
+
+
+void AS1130Simulator::setBusFrequency(uint32_t frequency)
+{
+  _busFrequency = frequency;
+}
+
+
+void AS1130Simulator::setBufferSize(uint8_t bufferSize)
+{
+  _bufferSize = bufferSize;
+}
+
+
+void AS1130Simulator::setLedConnected(uint8_t ledIndex, bool connected)
+{
+  const uint8_t segment = (ledIndex >> 4);
+  const uint8_t led = (ledIndex & 0xf);
+  if (segment >= 12 || led >= 11) {
+    return;
+  }
+  const uint8_t registerIndex = segment*2 + (led>>3);
+  const uint8_t bitMask = (1<<(led&7));
+  if (connected) {
+    _connectedLeds[registerIndex] |= bitMask;
+  } else {
+    _connectedLeds[registerIndex] &= ~bitMask;
+  }
+}
+
+
+void AS1130Simulator::setFrameHandler(FrameHandler frameHandler)
+{
+  _frameHandler = frameHandler;
+}
+
+
+uint8_t AS1130Simulator::getMemory(uint8_t registerSelection, uint8_t address) const
+{
+  const uint8_t *memory = const_cast<AS1130Simulator*>(this)->getMemoryPointer(registerSelection, address);
+  if (memory == nullptr) {
+    return 0x00;
+  }
+  return *memory;
+}
+
+
+void AS1130Simulator::render(uint8_t *brightness) const
+{
+  std::memset(brightness, 0, cLedIndexCount);
+  if (_mode == ModeOff || (_control[AS1130::CR_ShutdownAndOpenShort] & AS1130::SOSF_Shutdown) == 0) {
+    return;
+  }
+  const uint8_t scanLimit = (_control[AS1130::CR_DisplayOption] & AS1130::DOF_ScanLimitMask);
+  const uint8_t current = _control[AS1130::CR_CurrentSource];
+  const bool isDotCorrectionEnabled = (_control[AS1130::CR_Config] & AS1130::CF_DotCorrection) != 0;
+  const uint8_t fadeLevel = getFadeLevel();
+  // The movie mode register flag disables blinking if set.
+  bool isBlinkOffPhase = false;
+  if ((_control[AS1130::CR_MovieMode] & AS1130::MMF_BlinkEnabled) == 0) {
+    uint64_t blinkPeriod = cBlinkPeriod * getClockScale();
+    if ((_control[AS1130::CR_DisplayOption] & AS1130::DOF_BlinkFrequency) != 0) {
+      blinkPeriod *= 2;
+    }
+    isBlinkOffPhase = ((_time % blinkPeriod) >= (blinkPeriod / 2));
+  }
+  bool isBlinkAll;
+  if (_mode == ModeMovie) {
+    isBlinkAll = (_control[AS1130::CR_Movie] & AS1130::MF_BlinkMovie) != 0;
+  } else {
+    isBlinkAll = (_control[AS1130::CR_Picture] & AS1130::PF_BlinkPicture) != 0;
+  }
+  for (uint8_t segment = 0; segment <= scanLimit && segment < 12; ++segment) {
+    for (uint8_t led = 0; led < 11; ++led) {
+      const uint8_t ledIndex = (segment<<4) + led;
+      uint8_t frameIndex;
+      if (!getDisplayedLed(ledIndex, frameIndex)) {
+        continue;
+      }
+      uint8_t setIndex = (_frames[frameIndex][1] >> 5);
+      if (setIndex >= cBlinkAndPwmSetCount) {
+        setIndex = 0;
+      }
+      const uint8_t *blinkAndPwmSet = _blinkAndPwmSets[setIndex];
+      const bool doesBlink = isBlinkAll || (blinkAndPwmSet[segment*2 + (led>>3)] & (1<<(led&7))) != 0;
+      if (doesBlink && isBlinkOffPhase) {
+        continue;
+      }
+      uint16_t value = blinkAndPwmSet[0x18 + segment*11 + led];
+      value = (value * current) / 0xff;
+      if (isDotCorrectionEnabled) {
+        value = (value * _dotCorrection[segment]) / 0xff;
+      }
+      value = (value * fadeLevel) / 0xff;
+      brightness[ledIndex] = static_cast<uint8_t>(value);
+    }
+  }
+}
+
+
+void AS1130Simulator::writeAscii(std::FILE *file, Layout layout) const
+{
+  uint8_t brightness[cLedIndexCount];
+  render(brightness);
+  const uint8_t width = (layout == Layout12x11 ? 12 : 24);
+  const uint8_t height = (layout == Layout12x11 ? 11 : 5);
+  for (uint8_t y = 0; y < height; ++y) {
+    for (uint8_t x = 0; x < width; ++x) {
+      const uint8_t value = brightness[getRenderLedIndex(layout, x, y)];
+      if (value == 0) {
+        std::fputc('.', file);
+      } else if (value < 0x80) {
+        std::fputc('o', file);
+      } else {
+        std::fputc('#', file);
+      }
+    }
+    std::fputc('\n', file);
+  }
+}
+
+
+void AS1130Simulator::writePpm(std::FILE *file, Layout layout, uint8_t ledSize) const
+{
+  uint8_t brightness[cLedIndexCount];
+  render(brightness);
+  const uint8_t width = (layout == Layout12x11 ? 12 : 24);
+  const uint8_t height = (layout == Layout12x11 ? 11 : 5);
+  std::fprintf(file, "P6\n%d %d\n255\n", width*ledSize, height*ledSize);
+  for (uint16_t py = 0; py < height*ledSize; ++py) {
+    for (uint16_t px = 0; px < width*ledSize; ++px) {
+      const uint8_t value = brightness[getRenderLedIndex(layout, px/ledSize, py/ledSize)];
+      std::fputc(value, file);
+      std::fputc(value, file);
+      std::fputc(value, file);
+    }
+  }
+}
+
+
+void AS1130Simulator::beginTransmission(uint8_t chipAddress)
+{
+  _writeAddress = chipAddress;
+  _writeCount = 0;
+  _isFirstByte = true;
+  _isRegisterSelection = false;
+}
+
+
+bool AS1130Simulator::write(uint8_t data)
+{
+  if (_writeCount >= _bufferSize) {
+    return false;
+  }
+  ++_writeCount;
+  if (_writeAddress != _chipAddress) {
+    return true;
+  }
+  if (_isFirstByte) {
+    _isFirstByte = false;
+    if (data == cRegisterSelectionAddress) {
+      _isRegisterSelection = true;
+    } else {
+      _address = data;
+    }
+  } else if (_isRegisterSelection) {
+    _registerSelection = data;
+  } else {
+    writeMemory(data);
+  }
+  return true;
+}
+
+
+AS1130Bus::Status AS1130Simulator::endTransmission()
+{
+  advanceBusTime(_writeCount);
+  if (_writeAddress != _chipAddress) {
+    return StatusAddressNack;
+  }
+  if (_isDisplayChanged) {
+    _isDisplayChanged = false;
+    frameChanged();
+  }
+  return StatusSuccess;
+}
+
+
+uint8_t AS1130Simulator::requestFrom(uint8_t chipAddress, uint8_t count)
+{
+  advanceBusTime(count);
+  if (chipAddress != _chipAddress) {
+    _readCount = 0;
+    return 0;
+  }
+  _readCount = count;
+  return count;
+}
+
+
+uint8_t AS1130Simulator::read()
+{
+  if (_readCount == 0) {
+    return 0x00;
+  }
+  --_readCount;
+  const uint8_t data = getMemory(_registerSelection, _address);
+  if (_registerSelection == AS1130::RS_Control && _address == cControlInterruptStatus) {
+    // Reading the interrupt status clears it.
+    _control[cControlInterruptStatus] = 0;
+  }
+  ++_address;
+  return data;
+}
+
+
+uint8_t AS1130Simulator::getBufferSize() const
+{
+  return _bufferSize;
+}
+
+
+void AS1130Simulator::delay(uint16_t milliseconds)
+{
+  advanceTime(static_cast<uint64_t>(milliseconds) * 1000);
+}
+
+
+uint32_t AS1130Simulator::getMicroseconds() const
+{
+  return static_cast<uint32_t>(_time);
+}
+
+
+uint8_t* AS1130Simulator::getMemoryPointer(uint8_t registerSelection, uint8_t address)
+{
+  if (registerSelection >= AS1130::RS_OnOffFrame && registerSelection < AS1130::RS_OnOffFrame + cFrameCount) {
+    if (address < cFrameSize) {
+      return &_frames[registerSelection - AS1130::RS_OnOffFrame][address];
+    }
+  } else if (registerSelection >= AS1130::RS_BlinkAndPwmSet && registerSelection < AS1130::RS_BlinkAndPwmSet + cBlinkAndPwmSetCount) {
+    if (address < cBlinkAndPwmSetSize) {
+      return &_blinkAndPwmSets[registerSelection - AS1130::RS_BlinkAndPwmSet][address];
+    }
+  } else if (registerSelection == AS1130::RS_DotCorrection) {
+    if (address < cDotCorrectionSize) {
+      return &_dotCorrection[address];
+    }
+  } else if (registerSelection == AS1130::RS_Control) {
+    if (address < cControlSize) {
+      return &_control[address];
+    }
+  }
+  return nullptr;
+}
+
+
+void AS1130Simulator::writeMemory(uint8_t data)
+{
+  if (_registerSelection == AS1130::RS_Control) {
+    writeControlRegister(_address, data);
+  } else {
+    uint8_t *memory = getMemoryPointer(_registerSelection, _address);
+    if (memory != nullptr) {
+      *memory = data;
+      if (_mode != ModeOff) {
+        _isDisplayChanged = true;
+      }
+    }
+  }
+  ++_address;
+}
+
+
+void AS1130Simulator::writeControlRegister(uint8_t address, uint8_t data)
+{
+  if (address > AS1130::CR_ClockSynchronization) {
+    // The status registers and the open LED registers are read-only.
+    return;
+  }
+  const uint8_t previousData = _control[address];
+  _control[address] = data;
+  switch (address) {
+  case AS1130::CR_Picture:
+    if ((data & AS1130::PF_DisplayPicture) != 0) {
+      startPicture();
+    } else if (_mode == ModePicture) {
+      _mode = ModeOff;
+      updateStatus();
+      frameChanged();
+    }
+    break;
+  case AS1130::CR_Movie:
+    if ((data & AS1130::MF_DisplayMovie) != 0) {
+      startMovie();
+    } else if (_mode == ModeMovie) {
+      _mode = ModeOff;
+      if ((_control[AS1130::CR_Picture] & AS1130::PF_DisplayPicture) != 0) {
+        startPicture();
+      } else {
+        updateStatus();
+        frameChanged();
+      }
+    }
+    break;
+  case AS1130::CR_ShutdownAndOpenShort:
+    if ((previousData & AS1130::SOSF_Initialize) != 0 && (data & AS1130::SOSF_Initialize) == 0) {
+      // Clearing the initialize flag resets the control logic.
+      resetControl();
+      _control[AS1130::CR_ShutdownAndOpenShort] = data;
+      frameChanged();
+      return;
+    }
+    if ((previousData & AS1130::SOSF_ManualTest) == 0 && (data & AS1130::SOSF_ManualTest) != 0) {
+      _testEndTime = _time + cLedTestDuration * getClockScale();
+      updateStatus();
+    }
+    if (((previousData ^ data) & AS1130::SOSF_Shutdown) != 0) {
+      frameChanged();
+    }
+    break;
+  default:
+    if (_mode != ModeOff) {
+      _isDisplayChanged = true;
+    }
+    break;
+  }
+}
+
+
+void AS1130Simulator::resetControl()
+{
+  std::memset(_control, 0, sizeof(_control));
+  _mode = ModeOff;
+  _displayedFrame = 0;
+  _movieFrame = 0;
+  _movieLoop = 0;
+  _scrollStep = 0;
+  _frameStartTime = _time;
+  _nextStepTime = 0;
+  _testEndTime = 0;
+  _readCount = 0;
+}
+
+
+void AS1130Simulator::advanceBusTime(uint8_t byteCount)
+{
+  if (_busFrequency == 0) {
+    return;
+  }
+  // Start condition, address byte with ACK, data bytes with ACK and stop condition.
+  const uint64_t bitCount = 2 + (static_cast<uint64_t>(byteCount) + 1) * 9;
+  advanceTime((bitCount * 1000000 + _busFrequency - 1) / _busFrequency);
+}
+
+
+uint32_t AS1130Simulator::getClockScale() const
+{
+  switch (_control[AS1130::CR_ClockSynchronization] & 0b1100) {
+  case AS1130::Clock500kHz: return 2;
+  case AS1130::Clock125kHz: return 8;
+  case AS1130::Clock32kHz: return 32;
+  default: return 1;
+  }
+}
+
+
+uint64_t AS1130Simulator::getFrameDuration() const
+{
+  // A frame delay of zero is simulated as one frame delay step.
+  const uint8_t frameDelay = std::max(1, _control[AS1130::CR_FrameTimeScroll] & AS1130::FTSF_FrameDelay);
+  return cFrameDelayUnit * frameDelay * getClockScale();
+}
+
+
+uint8_t AS1130Simulator::getMovieFrameCount() const
+{
+  return (_control[AS1130::CR_MovieMode] & AS1130::MMF_MovieFramesMask) + 1;
+}
+
+
+uint8_t AS1130Simulator::getMovieLoopCount() const
+{
+  // The invalid value zero is simulated as one loop, the value 7 loops endless.
+  const uint8_t loopCount = (_control[AS1130::CR_DisplayOption] & AS1130::DOF_LoopsMask) >> 5;
+  return std::max<uint8_t>(1, loopCount);
+}
+
+
+uint8_t AS1130Simulator::getScrollStepCount() const
+{
+  if ((_control[AS1130::CR_FrameTimeScroll] & AS1130::FTSF_EnableScrolling) == 0) {
+    return 1;
+  }
+  if ((_control[AS1130::CR_FrameTimeScroll] & AS1130::FTSF_BlockSize) != 0) {
+    return 24;
+  }
+  return 12;
+}
+
+
+void AS1130Simulator::startPicture()
+{
+  if (_mode == ModeMovie) {
+    // A running movie has priority.
+    return;
+  }
+  _mode = ModePicture;
+  _displayedFrame = (_control[AS1130::CR_Picture] & AS1130::PF_PictureAddressMask);
+  _frameStartTime = _time;
+  startAutomaticTest();
+  if (_displayedFrame == (_control[AS1130::CR_InterruptFrameDefinition] & 0x3f)) {
+    setInterruptFlag(AS1130::IMF_SelectedPicture);
+  }
+  updateStatus();
+  frameChanged();
+}
+
+
+void AS1130Simulator::startMovie()
+{
+  _mode = ModeMovie;
+  _displayedFrame = (_control[AS1130::CR_Movie] & AS1130::MF_MovieAddressMask);
+  _movieFrame = 0;
+  _movieLoop = 0;
+  _scrollStep = 0;
+  _frameStartTime = _time;
+  _nextStepTime = _time + getFrameDuration();
+  startAutomaticTest();
+  updateStatus();
+  frameChanged();
+}
+
+
+void AS1130Simulator::stepMovie()
+{
+  const uint8_t firstFrame = (_control[AS1130::CR_Movie] & AS1130::MF_MovieAddressMask);
+  ++_scrollStep;
+  if (_scrollStep >= getScrollStepCount()) {
+    _scrollStep = 0;
+    ++_movieFrame;
+    if (_movieFrame >= getMovieFrameCount()) {
+      _movieFrame = 0;
+      ++_movieLoop;
+      const uint8_t loopCount = getMovieLoopCount();
+      if (loopCount != 7 && _movieLoop >= loopCount) {
+        // The movie is finished, keep the end frame displayed.
+        _mode = ModePicture;
+        if ((_control[AS1130::CR_MovieMode] & AS1130::MMF_EndLast) != 0) {
+          _displayedFrame = firstFrame + getMovieFrameCount() - 1;
+        } else {
+          _displayedFrame = firstFrame;
+        }
+        _frameStartTime = _time;
+        setInterruptFlag(AS1130::IMF_MovieFinished);
+        updateStatus();
+        frameChanged();
+        return;
+      }
+    }
+    _displayedFrame = firstFrame + _movieFrame;
+    if (_displayedFrame == (_control[AS1130::CR_InterruptFrameDefinition] & 0x3f)) {
+      setInterruptFlag(AS1130::IMF_SelectedPicture);
+    }
+  }
+  _frameStartTime = _time;
+  _nextStepTime = _time + getFrameDuration();
+  updateStatus();
+  frameChanged();
+}
+
+
+void AS1130Simulator::startAutomaticTest()
+{
+  if ((_control[AS1130::CR_ShutdownAndOpenShort] & AS1130::SOSF_AutoTest) != 0 && _testEndTime == 0) {
+    _testEndTime = _time + cLedTestDuration * getClockScale();
+  }
+}
+
+
+void AS1130Simulator::finishLedTest()
+{
+  _testEndTime = 0;
+  const bool isTestAll = (_control[AS1130::CR_ShutdownAndOpenShort] & AS1130::SOSF_TestAll) != 0;
+  bool hasOpenLed = false;
+  for (uint8_t segment = 0; segment < 12; ++segment) {
+    for (uint8_t led = 0; led < 16; ++led) {
+      const uint8_t ledIndex = (segment<<4) + led;
+      const uint8_t registerIndex = cControlOpenLedBase + (ledIndex>>3);
+      const uint8_t bitMask = (1<<(ledIndex&7));
+      bool isOk = true;
+      if (led < 11 && (isTestAll || (_mode != ModeOff && isLedOn(_displayedFrame, ledIndex)))) {
+        isOk = (_connectedLeds[segment*2 + (led>>3)] & (1<<(led&7))) != 0;
+      }
+      if (isOk && led < 11) {
+        _control[registerIndex] |= bitMask;
+      } else {
+        _control[registerIndex] &= ~bitMask;
+        hasOpenLed |= (led < 11);
+      }
+    }
+  }
+  if (hasOpenLed) {
+    setInterruptFlag(AS1130::IMF_OpenTestError);
+  }
+  updateStatus();
+}
+
+
+void AS1130Simulator::setInterruptFlag(uint8_t flag)
+{
+  if ((_control[AS1130::CR_InterruptMask] & flag) != 0) {
+    _control[cControlInterruptStatus] |= flag;
+  }
+}
+
+
+void AS1130Simulator::updateStatus()
+{
+  uint8_t status = (_displayedFrame << 2);
+  if (_testEndTime != 0) {
+    status |= AS1130::SF_TestOn;
+  }
+  if (_mode == ModeMovie) {
+    status |= AS1130::SF_MovieOn;
+  }
+  _control[cControlStatus] = status;
+}
+
+
+void AS1130Simulator::frameChanged()
+{
+  ++_frameCounter;
+  if (_frameHandler) {
+    _frameHandler(*this);
+  }
+}
+
+
+bool AS1130Simulator::isLedOn(uint8_t frameIndex, uint8_t ledIndex) const
+{
+  if (frameIndex >= cFrameCount) {
+    return false;
+  }
+  const uint8_t segment = (ledIndex >> 4);
+  const uint8_t led = (ledIndex & 0xf);
+  return (_frames[frameIndex][segment*2 + (led>>3)] & (1<<(led&7))) != 0;
+}
+
+
+bool AS1130Simulator::getDisplayedLed(uint8_t ledIndex, uint8_t &frameIndex) const
+{
+  frameIndex = _displayedFrame;
+  if (_mode != ModeMovie || _scrollStep == 0) {
+    return isLedOn(frameIndex, ledIndex);
+  }
+  // While scrolling, the display shows parts of the current and the next frame.
+  const uint8_t segment = (ledIndex >> 4);
+  const uint8_t led = (ledIndex & 0xf);
+  const bool isBlockMode = (_control[AS1130::CR_FrameTimeScroll] & AS1130::FTSF_BlockSize) != 0;
+  const bool isScrollLeft = (_control[AS1130::CR_FrameTimeScroll] & AS1130::FTSF_ScrollDirection) != 0;
+  uint8_t width = 12;
+  uint8_t column = segment;
+  uint8_t row = led;
+  if (isBlockMode) {
+    if (led >= 10) {
+      return false;
+    }
+    width = 24;
+    column = segment*2 + (led/5);
+    row = led%5;
+  }
+  int16_t sourceColumn;
+  if (isScrollLeft) {
+    sourceColumn = column + _scrollStep;
+  } else {
+    sourceColumn = column - _scrollStep;
+  }
+  if (sourceColumn < 0 || sourceColumn >= width) {
+    const uint8_t firstFrame = (_control[AS1130::CR_Movie] & AS1130::MF_MovieAddressMask);
+    frameIndex = firstFrame + ((_movieFrame + 1) % getMovieFrameCount());
+    sourceColumn = (sourceColumn < 0 ? sourceColumn + width : sourceColumn - width);
+  }
+  uint8_t sourceLedIndex;
+  if (isBlockMode) {
+    sourceLedIndex = ((sourceColumn>>1)<<4) + ((sourceColumn&1)*5) + row;
+  } else {
+    sourceLedIndex = (sourceColumn<<4) + row;
+  }
+  return isLedOn(frameIndex, sourceLedIndex);
+}
+
+
+uint8_t AS1130Simulator::getFadeLevel() const
+{
+  if (_mode != ModeMovie || (_control[AS1130::CR_FrameTimeScroll] & AS1130::FTSF_FrameFade) == 0) {
+    return 0xff;
+  }
+  // Fade in during the first and fade out during the last quarter of the frame.
+  const uint64_t frameDuration = getFrameDuration();
+  const uint64_t fadeDuration = frameDuration / 4;
+  const uint64_t frameTime = _time - _frameStartTime;
+  const uint64_t distance = std::min(frameTime, frameDuration - std::min(frameTime, frameDuration));
+  if (distance >= fadeDuration) {
+    return 0xff;
+  }
+  return static_cast<uint8_t>((distance * 0xff) / fadeDuration);
+}
+
+
+uint8_t AS1130Simulator::getRenderLedIndex(Layout layout, uint8_t x, uint8_t y) const
+{
+  if (layout == Layout12x11) {
+    return (x<<4) + y;
+  }
+  return ((x>>1)<<4) + ((x&1)*5) + y;
+}
+
+
+}
+
+
+#endif
@@ -0,0 +1,328 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#pragma once
+#ifndef ARDUINO
+
+
+#include "LRAS1130Bus.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <functional>
+
+
+namespace lr {
+
+
+/// @brief A software model of the AS1130 chip for host builds.
+///
+/// The simulator implements the AS1130Bus interface, so an AS1130 instance
+/// can be used with it like with a real chip. It models all register banks,
+/// the picture and movie playback with frame delays, scrolling, fading and
+/// blinking, the status registers and the LED test.
+///
+/// Time in the simulator is only advancing if you call advanceTime(), if the
+/// driver calls delay() or by the time needed to transfer bytes on the bus.
+/// The timing is modelled with the resolution of single bus transactions and
+/// display frames, not of the internal multiplexing of the chip.
+///
+/// Use writeAscii() or writePpm() to render the currently displayed image,
+/// e.g. from a frame handler which is called each time the displayed frame
+/// changes.
+///
+class AS1130Simulator : public AS1130Bus
+{
+public:
+  /// @brief The layout used to render the LEDs.
+  ///
+  enum Layout : uint8_t {
+    Layout12x11, ///< Render the LEDs as 12x11 matrix.
+    Layout24x5 ///< Render the LEDs as 24x5 matrix.
+  };
+
+  /// @brief The function called if the displayed frame changes.
+  ///
+  typedef std::function<void(const AS1130Simulator &simulator)> FrameHandler;
+
+  /// @brief The number of LED indexes, including the unused ones.
+  ///
+  static const uint8_t cLedIndexCount = 0xc0;
+
+public:
+  /// @brief Create a new simulated chip.
+  ///
+  /// @param chipAddress The I2C address of the simulated chip.
+  ///
+  explicit AS1130Simulator(uint8_t chipAddress = 0x30);
+
+public:
+  /// @brief Reset the chip to the power-on state.
+  ///
+  void reset();
+
+  /// @brief Advance the simulated time.
+  ///
+  /// @param microseconds The time to advance.
+  ///
+  void advanceTime(uint64_t microseconds);
+
+  /// @brief Get the current simulated time.
+  ///
+  /// @return The time since the simulation started in microseconds.
+  ///
+  inline uint64_t getTime() const { return _time; }
+
+  /// @brief Set the frequency of the simulated bus.
+  ///
+  /// Each transaction advances the time by the time needed to transfer
+  /// all its bits. Set the frequency to zero to disable this.
+  ///
+  /// @param frequency The bus frequency in Hz.
+  ///
+  void setBusFrequency(uint32_t frequency);
+
+  /// @brief Set the size of the transmit buffer.
+  ///
+  /// @param bufferSize The size of the buffer in bytes, including the register address.
+  ///
+  void setBufferSize(uint8_t bufferSize);
+
+  /// @brief Set which LEDs are physically connected.
+  ///
+  /// This is used for the LED test. By default all LEDs are connected.
+  ///
+  /// @param ledIndex The LED index.
+  /// @param connected `true` if the LED is connected, `false` if it is open.
+  ///
+  void setLedConnected(uint8_t ledIndex, bool connected);
+
+  /// @brief Set the function which is called each time the displayed frame changes.
+  ///
+  /// @param frameHandler The function to call.
+  ///
+  void setFrameHandler(FrameHandler frameHandler);
+
+  /// @brief Get the number of displayed frame changes.
+  ///
+  /// @return The number of times the displayed frame changed.
+  ///
+  inline uint32_t getFrameCounter() const { return _frameCounter; }
+
+  /// @brief Check if the interrupt output is active.
+  ///
+  /// @return `true` if any flag is set in the interrupt status register.
+  ///
+  inline bool isInterruptActive() const { return _control[cControlInterruptStatus] != 0; }
+
+  /// @brief Access a byte in the simulated memory.
+  ///
+  /// @param registerSelection The register selection address.
+  /// @param address The address of the register.
+  /// @return The value of the register, or zero for invalid addresses.
+  ///
+  uint8_t getMemory(uint8_t registerSelection, uint8_t address) const;
+
+  /// @brief Render the brightness of all LEDs.
+  ///
+  /// @param brightness An array with cLedIndexCount bytes, which receives the
+  ///   brightness for each LED index.
+  ///
+  void render(uint8_t *brightness) const;
+
+  /// @brief Render the displayed image as ASCII art.
+  ///
+  /// Dark LEDs are written as `.`, LEDs with less than half brightness as `o`
+  /// and bright LEDs as `#`.
+  ///
+  /// @param file The file to write to.
+  /// @param layout The layout of the LEDs.
+  ///
+  void writeAscii(std::FILE *file, Layout layout) const;
+
+  /// @brief Render the displayed image as binary PPM image.
+  ///
+  /// @param file The file to write to.
+  /// @param layout The layout of the LEDs.
+  /// @param ledSize The size of one LED in pixels.
+  ///
+  void writePpm(std::FILE *file, Layout layout, uint8_t ledSize = 8) const;
+
+public: // Implement AS1130Bus
+  virtual void beginTransmission(uint8_t chipAddress) override;
+  virtual bool write(uint8_t data) override;
+  virtual Status endTransmission() override;
+  virtual uint8_t requestFrom(uint8_t chipAddress, uint8_t count) override;
+  virtual uint8_t read() override;
+  virtual uint8_t getBufferSize() const override;
+  virtual void delay(uint16_t milliseconds) override;
+  virtual uint32_t getMicroseconds() const override;
+
+private:
+  /// @brief The sizes and addresses of the simulated memory.
+  ///
+  enum : uint8_t {
+    cFrameCount = 36,
+    cFrameSize = 0x18,
+    cBlinkAndPwmSetCount = 6,
+    cBlinkAndPwmSetSize = 0x9c,
+    cDotCorrectionSize = 12,
+    cControlSize = 0x38,
+    cControlInterruptStatus = 0x0e,
+    cControlStatus = 0x0f,
+    cControlOpenLedBase = 0x20
+  };
+
+  /// @brief The display mode.
+  ///
+  enum Mode : uint8_t {
+    ModeOff, ///< Nothing is displayed.
+    ModePicture, ///< A picture is displayed.
+    ModeMovie, ///< A movie is running.
+  };
+
+private:
+  /// @brief Get a pointer to a byte in the simulated memory.
+  ///
+  /// @return The pointer to the byte, or `nullptr` for an invalid address.
+  ///
+  uint8_t* getMemoryPointer(uint8_t registerSelection, uint8_t address);
+
+  /// @brief Write a byte at the current address and increment the address.
+  ///
+  void writeMemory(uint8_t data);
+
+  /// @brief Write a control register and process the changes.
+  ///
+  void writeControlRegister(uint8_t address, uint8_t data);
+
+  /// @brief Reset all control registers and the display state.
+  ///
+  void resetControl();
+
+  /// @brief Advance the time by the duration of a transaction on the bus.
+  ///
+  void advanceBusTime(uint8_t byteCount);
+
+  /// @brief Get the factor of the selected clock compared to the 1 MHz clock.
+  ///
+  uint32_t getClockScale() const;
+
+  /// @brief Get the duration of one frame or scroll step in microseconds.
+  ///
+  uint64_t getFrameDuration() const;
+
+  /// @brief Get the number of frames in the movie.
+  ///
+  uint8_t getMovieFrameCount() const;
+
+  /// @brief Get the number of movie loops, 7 for endless.
+  ///
+  uint8_t getMovieLoopCount() const;
+
+  /// @brief Get the number of steps to display one movie frame.
+  ///
+  uint8_t getScrollStepCount() const;
+
+  /// @brief Start displaying the picture from the picture register.
+  ///
+  void startPicture();
+
+  /// @brief Start the movie from the movie register.
+  ///
+  void startMovie();
+
+  /// @brief Advance the movie by one step.
+  ///
+  void stepMovie();
+
+  /// @brief Start a LED test if the automatic test is enabled.
+  ///
+  void startAutomaticTest();
+
+  /// @brief Finish the running LED test and write the results.
+  ///
+  void finishLedTest();
+
+  /// @brief Set a flag in the interrupt status, if it is enabled in the mask.
+  ///
+  void setInterruptFlag(uint8_t flag);
+
+  /// @brief Update the status register.
+  ///
+  void updateStatus();
+
+  /// @brief Count the frame change and call the frame handler.
+  ///
+  void frameChanged();
+
+  /// @brief Check if a LED is enabled in a frame.
+  ///
+  bool isLedOn(uint8_t frameIndex, uint8_t ledIndex) const;
+
+  /// @brief Check if a LED is displayed, respecting the scroll position.
+  ///
+  /// @param ledIndex The LED index on the display.
+  /// @param frameIndex Receives the frame index the LED is taken from.
+  /// @return `true` if the LED is on.
+  ///
+  bool getDisplayedLed(uint8_t ledIndex, uint8_t &frameIndex) const;
+
+  /// @brief Get the brightness factor for frame fading.
+  ///
+  uint8_t getFadeLevel() const;
+
+  /// @brief Get the LED index for a coordinate in the render layout.
+  ///
+  uint8_t getRenderLedIndex(Layout layout, uint8_t x, uint8_t y) const;
+
+private:
+  uint8_t _chipAddress; ///< The I2C address of the chip.
+  uint8_t _bufferSize; ///< The size of the transmit buffer.
+  uint32_t _busFrequency; ///< The simulated bus frequency in Hz.
+  uint8_t _writeAddress; ///< The target chip address of the current write.
+  uint8_t _writeCount; ///< The number of bytes in the current write.
+  bool _isFirstByte; ///< If the next written byte is the register address.
+  bool _isRegisterSelection; ///< If the current write is a register selection.
+  bool _isDisplayChanged; ///< If the current write changed the displayed image.
+  uint8_t _registerSelection; ///< The selected register bank.
+  uint8_t _address; ///< The current address pointer.
+  uint8_t _readCount; ///< The number of bytes left to read.
+  uint64_t _time; ///< The simulated time in microseconds.
+  Mode _mode; ///< The current display mode.
+  uint8_t _displayedFrame; ///< The currently displayed frame.
+  uint8_t _movieFrame; ///< The frame position in the movie, relative to the first frame.
+  uint8_t _movieLoop; ///< The current movie loop.
+  uint8_t _scrollStep; ///< The scroll position in the current frame.
+  uint64_t _frameStartTime; ///< The time when the current frame started.
+  uint64_t _nextStepTime; ///< The time for the next movie step.
+  uint64_t _testEndTime; ///< The time when the LED test finishes, or zero.
+  uint32_t _frameCounter; ///< The number of frame changes.
+  FrameHandler _frameHandler; ///< The handler called if the frame changes.
+  uint8_t _frames[cFrameCount][cFrameSize]; ///< The on/off frames.
+  uint8_t _blinkAndPwmSets[cBlinkAndPwmSetCount][cBlinkAndPwmSetSize]; ///< The blink&PWM sets.
+  uint8_t _dotCorrection[cDotCorrectionSize]; ///< The dot correction data.
+  uint8_t _control[cControlSize]; ///< The control registers.
+  uint8_t _connectedLeds[cFrameSize]; ///< The connected LEDs in frame register layout.
+};
+
+
+}
+
+
+#endif
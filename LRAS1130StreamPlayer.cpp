@@ -0,0 +1,178 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#include "LRAS1130StreamPlayer.h"
+
+
+#ifdef ARDUINO_ARCH_AVR
+// Make it compatible with the standart
+#include <string.h>
+namespace std { using ::memset; }
+#else
+#include <cstring>
+#endif
+
+
+namespace lr {
+
+
+AS1130StreamPlayer::AS1130StreamPlayer(AS1130 &chip)
+  : _chip(&chip),
+    _source(nullptr),
+    _context(nullptr),
+    _frameNumber(0),
+    _state(StateStopped),
+    _isInterruptEnabled(false),
+    _firstFrameIndex(0),
+    _halfSize(0),
+    _nextHalf(0),
+    _endPosition(0)
+{
+  std::memset(_lastFrame.registers, 0, AS1130FrameData::cSize);
+}
+
+
+void AS1130StreamPlayer::setInterruptEnabled(bool enabled)
+{
+  _isInterruptEnabled = enabled;
+}
+
+
+bool AS1130StreamPlayer::start(FrameSource source, void *context, uint8_t firstFrameIndex, uint8_t frameCount)
+{
+  // The ring has to end at the last frame of the chip, and each half needs at least two frames.
+  if (firstFrameIndex >= cMaximumFrameCount) {
+    return false;
+  }
+  if (frameCount > cMaximumFrameCount - firstFrameIndex) {
+    frameCount = cMaximumFrameCount - firstFrameIndex;
+  }
+  if (frameCount < cMinimumFrameCount) {
+    return false;
+  }
+  _chip->stopMovie();
+  _source = source;
+  _context = context;
+  _frameNumber = 0;
+  std::memset(_lastFrame.registers, 0, AS1130FrameData::cSize);
+  _state = StatePlaying;
+  _firstFrameIndex = firstFrameIndex;
+  _halfSize = (frameCount>>1);
+  fillHalf(0);
+  fillHalf(1);
+  // The chip starts playing the first half, so it is refilled next.
+  _nextHalf = 0;
+  if (_isInterruptEnabled) {
+    updateInterruptFrame();
+    _chip->setControlRegisterBits(AS1130::CR_InterruptMask, AS1130::IMF_SelectedPicture);
+  }
+  _chip->setMovieFrameCount(_halfSize<<1);
+  _chip->setMovieLoopCount(AS1130::MovieLoopEndless);
+  _chip->startMovie(_firstFrameIndex);
+  return true;
+}
+
+
+void AS1130StreamPlayer::stop()
+{
+  if (_state != StateStopped) {
+    _chip->stopMovie();
+    _chip->stopPicture();
+    _state = StateStopped;
+  }
+}
+
+
+bool AS1130StreamPlayer::poll()
+{
+  if (!isPlaying()) {
+    return false;
+  }
+  const uint8_t position = getRingPosition(_chip->getDisplayedFrame());
+  if (_state == StateEnding) {
+    // All frames from the end position to the end of the last filled half
+    // are copies of the last frame. Stop while the chip displays one of them.
+    const uint8_t ringSize = (_halfSize<<1);
+    const uint8_t holdEnd = ((_nextHalf^1)+1)*_halfSize - 1;
+    const uint8_t holdLength = (holdEnd + ringSize - _endPosition) % ringSize;
+    if ((position + ringSize - _endPosition) % ringSize <= holdLength) {
+      // The movie has priority, so the picture is displayed without a gap.
+      _chip->startPicture(_firstFrameIndex + _endPosition);
+      _chip->stopMovie();
+      _state = StateFinished;
+      return false;
+    }
+    // Otherwise keep refilling the other half, now with copies of the last
+    // frame, so the chip never loops back into old frames.
+  }
+  const uint8_t playedHalf = (position >= _halfSize ? 1 : 0);
+  if (playedHalf == _nextHalf) {
+    return false;
+  }
+  fillHalf(_nextHalf);
+  _nextHalf ^= 1;
+  if (_isInterruptEnabled) {
+    updateInterruptFrame();
+  }
+  return true;
+}
+
+
+void AS1130StreamPlayer::fillHalf(uint8_t half)
+{
+  const uint8_t firstPosition = half*_halfSize;
+  for (uint8_t i = 0; i < _halfSize; ++i) {
+    const uint8_t position = firstPosition + i;
+    if (_state == StatePlaying) {
+      if (_source(_context, _frameNumber, _lastFrame)) {
+        ++_frameNumber;
+      } else {
+        _state = StateEnding;
+        _endPosition = (position == 0 ? (_halfSize<<1) : position) - 1;
+      }
+    }
+    // After the end of the animation, the last frame is repeated.
+    _chip->setOnOffFrameRaw(_firstFrameIndex + position, _lastFrame);
+  }
+}
+
+
+void AS1130StreamPlayer::updateInterruptFrame()
+{
+  if (_state == StateEnding) {
+    // Signal the display of the last frame of the animation.
+    _chip->setInterruptFrame(_firstFrameIndex + _endPosition);
+  } else {
+    // Signal when the chip enters the other half, so the next half can be refilled.
+    _chip->setInterruptFrame(_firstFrameIndex + (_nextHalf^1)*_halfSize);
+  }
+}
+
+
+uint8_t AS1130StreamPlayer::getRingPosition(uint8_t frameIndex) const
+{
+  if (frameIndex < _firstFrameIndex) {
+    return 0;
+  }
+  return frameIndex - _firstFrameIndex;
+}
+
+
+}
+
+
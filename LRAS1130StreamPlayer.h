@@ -0,0 +1,184 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#pragma once
+
+
+#include "LRAS1130.h"
+
+
+namespace lr {
+
+
+/// @brief A player for animations with an unlimited number of frames.
+///
+/// The player uses a ring of on/off frames on the chip, which is split into
+/// two halves. While the chip plays the movie in one half of the ring, the
+/// player refills the other half with the next frames from a source callback.
+/// This way animations of any length are played at the full frame rate of the chip.
+///
+/// Configure the chip as usual (RAM configuration, frame delay, PWM sets),
+/// then start the player and call poll() frequently. The time between two
+/// calls of poll() has to be shorter than the time to play one half of the ring.
+///
+/// Example:
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// bool nextFrame(void *context, uint32_t frameNumber, AS1130FrameData &frameData) {
+///   frameData = ...;
+///   return true;
+/// }
+///
+/// AS1130StreamPlayer player(ledDriver);
+/// player.start(nextFrame, nullptr, 0, 36);
+///
+/// void loop() {
+///   player.poll();
+/// }
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+class AS1130StreamPlayer
+{
+public:
+  /// @brief The callback to get the next frame of the animation.
+  ///
+  /// @param context The context pointer passed to start().
+  /// @param frameNumber The number of the requested frame, starting with zero.
+  /// @param frameData The frame data to fill.
+  /// @return `true` if the frame data was set, `false` if the animation has ended.
+  ///
+  typedef bool (*FrameSource)(void *context, uint32_t frameNumber, AS1130FrameData &frameData);
+
+  /// @brief The state of the player.
+  ///
+  enum State : uint8_t {
+    StateStopped, ///< The player is stopped.
+    StatePlaying, ///< The player is playing frames from the source.
+    StateEnding, ///< The source has ended, the last frames are played.
+    StateFinished, ///< The last frame of the animation is displayed as picture.
+  };
+
+  /// @brief The number of on/off frames on the chip.
+  ///
+  static const uint8_t cMaximumFrameCount = 36;
+
+  /// @brief The minimum number of frames in the ring.
+  ///
+  static const uint8_t cMinimumFrameCount = 4;
+
+public:
+  /// @brief Create a new player for the given chip.
+  ///
+  /// @param chip The chip to use.
+  ///
+  AS1130StreamPlayer(AS1130 &chip);
+
+public:
+  /// @brief Use the selected picture interrupt to signal the refill.
+  ///
+  /// If enabled, the player sets the interrupt frame of the chip to the
+  /// frame where the next refill is required and enables the
+  /// IMF_SelectedPicture interrupt. Call poll() if the interrupt line of
+  /// the chip is active. The player does not read the interrupt status,
+  /// you have to read it using AS1130::getInterruptStatus() to clear it.
+  ///
+  /// The interrupt is disabled by default. Call this function before start().
+  ///
+  /// @param enabled True to enable the interrupt.
+  ///
+  void setInterruptEnabled(bool enabled);
+
+  /// @brief Start playing a new animation.
+  ///
+  /// This fills the whole ring with frames from the source, configures the
+  /// movie to loop over the ring and starts it.
+  ///
+  /// @param source The callback for the frames.
+  /// @param context A pointer passed to the callback.
+  /// @param firstFrameIndex The first frame of the ring.
+  /// @param frameCount The number of frames in the ring. An even number between 4 and 36.
+  ///   The ring has to fit into the frames of the current RAM configuration.
+  ///   An odd number is rounded down, and the ring is shortened so it ends
+  ///   at frame 35.
+  /// @return `true` if the player was started, `false` if less than 4 frames
+  ///   remain for the ring. In this case, nothing is written to the chip.
+  ///
+  bool start(FrameSource source, void *context, uint8_t firstFrameIndex, uint8_t frameCount);
+
+  /// @brief Stop the movie and the player.
+  ///
+  void stop();
+
+  /// @brief Refill the ring if required.
+  ///
+  /// This reads the displayed frame from the chip. If the chip has started
+  /// to play the other half of the ring, the played half is refilled.
+  ///
+  /// @return `true` if frames were written to the chip.
+  ///
+  bool poll();
+
+  /// @brief Get the current state of the player.
+  ///
+  inline State getState() const { return _state; }
+
+  /// @brief Check if the player is playing an animation.
+  ///
+  /// @return `true` if frames of the animation are played.
+  ///
+  inline bool isPlaying() const { return _state == StatePlaying || _state == StateEnding; }
+
+  /// @brief Get the number of frames read from the source.
+  ///
+  inline uint32_t getFrameNumber() const { return _frameNumber; }
+
+private:
+  /// @brief Fill one half of the ring with frames from the source.
+  ///
+  /// @param half The half to fill, 0 or 1.
+  ///
+  void fillHalf(uint8_t half);
+
+  /// @brief Set the interrupt frame for the next call of poll().
+  ///
+  void updateInterruptFrame();
+
+  /// @brief Get the position of a frame in the ring.
+  ///
+  /// @param frameIndex The index of the frame on the chip.
+  /// @return The position in the ring.
+  ///
+  uint8_t getRingPosition(uint8_t frameIndex) const;
+
+private:
+  AS1130 *_chip; ///< The chip.
+  FrameSource _source; ///< The source for the frames.
+  void *_context; ///< The context for the source.
+  uint32_t _frameNumber; ///< The number of the next frame from the source.
+  AS1130FrameData _lastFrame; ///< The last frame from the source.
+  State _state; ///< The current state.
+  bool _isInterruptEnabled; ///< If the selected picture interrupt is used.
+  uint8_t _firstFrameIndex; ///< The index of the first frame of the ring.
+  uint8_t _halfSize; ///< The number of frames in one half of the ring.
+  uint8_t _nextHalf; ///< The half which is refilled next.
+  uint8_t _endPosition; ///< The ring position of the last frame of the animation.
+};
+
+
+}
+
+
@@ -0,0 +1,255 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#include "LRAS1130TransactionQueue.h"
+
+
+#ifdef ARDUINO_ARCH_AVR
+// Make it compatible with the standart
+#include <string.h>
+namespace std { using ::memcpy; }
+#else
+#include <cstring>
+#endif
+
+
+namespace lr {
+
+
+AS1130TransactionQueue::AS1130TransactionQueue(AS1130Bus &bus, uint8_t *buffer, uint16_t bufferSize)
+  : _bus(&bus),
+    _buffer(buffer),
+    _bufferSize(bufferSize),
+    _head(0),
+    _used(0),
+    _isDelayActive(false),
+    _delayDuration(0),
+    _delayStartTime(0),
+    _lastError(StatusSuccess),
+    _chipAddress(0),
+    _transmissionSize(0)
+{
+}
+
+
+void AS1130TransactionQueue::addCallback(Callback callback, void *context)
+{
+  uint8_t header[sizeof(Callback) + sizeof(void*)];
+  std::memcpy(header, &callback, sizeof(Callback));
+  std::memcpy(header + sizeof(Callback), &context, sizeof(void*));
+  if (!addEntry(EntryCallback, header, sizeof(header), nullptr, 0)) {
+    // The buffer is too small for the callback, but all previous transmissions are sent.
+    const Status status = _lastError;
+    _lastError = StatusSuccess;
+    callback(context, status);
+  }
+}
+
+
+bool AS1130TransactionQueue::poll(uint32_t currentTime)
+{
+  if (_isDelayActive) {
+    if (currentTime - _delayStartTime < _delayDuration) {
+      return true;
+    }
+    _isDelayActive = false;
+  }
+  bool isTransmissionSent = false;
+  while (_used > 0 && !_isDelayActive) {
+    // Send at most one transmission, but process all following callbacks and delays.
+    if (_buffer[_head] == EntryTransmission) {
+      if (isTransmissionSent) {
+        break;
+      }
+      isTransmissionSent = true;
+    }
+    processEntry(currentTime, false);
+  }
+  return !isEmpty();
+}
+
+
+void AS1130TransactionQueue::flush()
+{
+  if (_isDelayActive) {
+    // The current time is not known, so wait for the full delay.
+    _bus->delay(_delayDuration);
+    _isDelayActive = false;
+  }
+  while (_used > 0) {
+    processEntry(0, true);
+  }
+}
+
+
+void AS1130TransactionQueue::beginTransmission(uint8_t chipAddress)
+{
+  _chipAddress = chipAddress;
+  _transmissionSize = 0;
+}
+
+
+bool AS1130TransactionQueue::write(uint8_t data)
+{
+  if (_transmissionSize >= getBufferSize()) {
+    return false;
+  }
+  _transmission[_transmissionSize] = data;
+  ++_transmissionSize;
+  return true;
+}
+
+
+AS1130Bus::Status AS1130TransactionQueue::endTransmission()
+{
+  const uint8_t header[2] = {_chipAddress, _transmissionSize};
+  if (!addEntry(EntryTransmission, header, sizeof(header), _transmission, _transmissionSize)) {
+    return StatusDataTooLong;
+  }
+  return StatusSuccess;
+}
+
+
+uint8_t AS1130TransactionQueue::requestFrom(uint8_t chipAddress, uint8_t count)
+{
+  flush();
+  return _bus->requestFrom(chipAddress, count);
+}
+
+
+uint8_t AS1130TransactionQueue::read()
+{
+  return _bus->read();
+}
+
+
+uint8_t AS1130TransactionQueue::getBufferSize() const
+{
+  const uint8_t busBufferSize = _bus->getBufferSize();
+  return busBufferSize < cMaximumTransmissionSize ? busBufferSize : cMaximumTransmissionSize;
+}
+
+
+void AS1130TransactionQueue::delay(uint16_t milliseconds)
+{
+  const uint8_t header[2] = {static_cast<uint8_t>(milliseconds), static_cast<uint8_t>(milliseconds>>8)};
+  if (!addEntry(EntryDelay, header, sizeof(header), nullptr, 0)) {
+    // The buffer is too small for the delay, but all previous transmissions are sent.
+    _bus->delay(milliseconds);
+  }
+}
+
+
+uint32_t AS1130TransactionQueue::getMicroseconds() const
+{
+  return _bus->getMicroseconds();
+}
+
+
+bool AS1130TransactionQueue::addEntry(EntryType type, const uint8_t *header, uint8_t headerSize, const uint8_t *data, uint8_t dataSize)
+{
+  const uint16_t entrySize = 1 + headerSize + dataSize;
+  while (_bufferSize - _used < entrySize) {
+    if (_used == 0) {
+      // The entry can never fit into the buffer.
+      return false;
+    }
+    // Make space, the caller has to wait.
+    if (_isDelayActive) {
+      _bus->delay(_delayDuration);
+      _isDelayActive = false;
+    }
+    processEntry(0, true);
+  }
+  pushByte(type);
+  for (uint8_t i = 0; i < headerSize; ++i) {
+    pushByte(header[i]);
+  }
+  for (uint8_t i = 0; i < dataSize; ++i) {
+    pushByte(data[i]);
+  }
+  return true;
+}
+
+
+void AS1130TransactionQueue::processEntry(uint32_t currentTime, bool isBlocking)
+{
+  const uint8_t type = popByte();
+  if (type == EntryTransmission) {
+    const uint8_t chipAddress = popByte();
+    const uint8_t size = popByte();
+    _bus->beginTransmission(chipAddress);
+    for (uint8_t i = 0; i < size; ++i) {
+      _bus->write(popByte());
+    }
+    const Status status = _bus->endTransmission();
+    if (status != StatusSuccess) {
+      _lastError = status;
+    }
+  } else if (type == EntryDelay) {
+    uint16_t duration = popByte();
+    duration |= (static_cast<uint16_t>(popByte()) << 8);
+    if (isBlocking) {
+      _bus->delay(duration);
+    } else {
+      _isDelayActive = true;
+      _delayDuration = duration;
+      _delayStartTime = currentTime;
+    }
+  } else {
+    uint8_t data[sizeof(Callback) + sizeof(void*)];
+    for (uint8_t i = 0; i < sizeof(data); ++i) {
+      data[i] = popByte();
+    }
+    Callback callback;
+    void *context;
+    std::memcpy(&callback, data, sizeof(Callback));
+    std::memcpy(&context, data + sizeof(Callback), sizeof(void*));
+    const Status status = _lastError;
+    _lastError = StatusSuccess;
+    callback(context, status);
+  }
+}
+
+
+void AS1130TransactionQueue::pushByte(uint8_t data)
+{
+  uint16_t position = _head + _used;
+  if (position >= _bufferSize) {
+    position -= _bufferSize;
+  }
+  _buffer[position] = data;
+  ++_used;
+}
+
+
+uint8_t AS1130TransactionQueue::popByte()
+{
+  const uint8_t data = _buffer[_head];
+  ++_head;
+  if (_head >= _bufferSize) {
+    _head = 0;
+  }
+  --_used;
+  return data;
+}
+
+
+}
+
+
@@ -0,0 +1,190 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#pragma once
+
+
+#include "LRAS1130Bus.h"
+
+
+namespace lr {
+
+
+/// @brief A bus which queues all write transmissions.
+///
+/// The queue stores all write transmissions in a ring buffer and sends them
+/// later to the target bus, one transmission for each call of poll(). Use it
+/// as bus for an AS1130 instance, so all calls of the chip return immediately
+/// and the main loop can do other work while the data is sent.
+///
+/// Calls of delay(), e.g. in AS1130::resetChip(), are queued as well. The
+/// following transmissions are sent after the delay has passed. Use
+/// addCallback() to get notified if all previous transmissions are sent.
+///
+/// Reads can not be queued. If a read is requested, the queue is flushed
+/// first, which blocks until all transmissions are sent. Enable the control
+/// register cache of the chip to avoid most reads.
+///
+/// If the ring buffer is full, a new transmission blocks until there is
+/// enough space.
+///
+/// Because the status of a transmission is not known while it is queued,
+/// endTransmission() returns StatusSuccess for every queued transmission.
+/// The status is reported to the next callback. Only a transmission which
+/// can never fit into the buffer is rejected at once, with StatusDataTooLong.
+///
+/// At the time of the callback, the chip instance already assumes that all
+/// queued writes were successful: the register selection, the control
+/// register cache and the frame shadow reflect the queued data. If there was
+/// an error, call AS1130::invalidateChipState() from the callback, so the
+/// lost writes are not skipped later, and repeat the failed operations.
+///
+/// Example:
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+/// uint8_t queueBuffer[128];
+/// AS1130TransactionQueue queue(AS1130WireBus::getDefault(), queueBuffer, sizeof(queueBuffer));
+/// AS1130 ledDriver(queue);
+///
+/// void loop() {
+///   queue.poll(millis());
+///   // ...
+/// }
+/// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+///
+class AS1130TransactionQueue : public AS1130Bus
+{
+public:
+  /// @brief The callback which is called after all previous transmissions were sent.
+  ///
+  /// @param context The context passed to addCallback().
+  /// @param status The status of the last failed transmission since the previous
+  ///   callback, or StatusSuccess if all transmissions were successful.
+  ///
+  typedef void (*Callback)(void *context, Status status);
+
+  /// @brief The maximum number of bytes in one transmission.
+  ///
+  static const uint8_t cMaximumTransmissionSize = 32;
+
+public:
+  /// @brief Create a new queue.
+  ///
+  /// @param bus The target bus where the transmissions are sent.
+  /// @param buffer The buffer for the queued transmissions.
+  /// @param bufferSize The size of the buffer in bytes. The buffer has to be
+  ///   large enough for at least one transmission, plus three bytes.
+  ///
+  AS1130TransactionQueue(AS1130Bus &bus, uint8_t *buffer, uint16_t bufferSize);
+
+public:
+  /// @brief Queue a callback.
+  ///
+  /// The callback is called from poll() or flush(), after all previously
+  /// queued transmissions were sent.
+  ///
+  /// @param callback The function to call.
+  /// @param context A pointer passed to the callback.
+  ///
+  void addCallback(Callback callback, void *context);
+
+  /// @brief Send the next queued transmission.
+  ///
+  /// Call this function frequently from your main loop or from a timer.
+  /// Each call sends at most one transmission and calls all callbacks
+  /// which are ready.
+  ///
+  /// @param currentTime The current time in milliseconds, e.g. from `millis()`.
+  /// @return `true` if there are more queued entries.
+  ///
+  bool poll(uint32_t currentTime);
+
+  /// @brief Send all queued transmissions.
+  ///
+  /// This blocks until the queue is empty. Queued delays are done using
+  /// the delay of the target bus.
+  ///
+  void flush();
+
+  /// @brief Check if the queue is empty.
+  ///
+  inline bool isEmpty() const { return _used == 0 && !_isDelayActive; }
+
+  /// @brief Get the number of used bytes in the ring buffer.
+  ///
+  inline uint16_t getUsedSize() const { return _used; }
+
+public: // Implement AS1130Bus
+  virtual void beginTransmission(uint8_t chipAddress) override;
+  virtual bool write(uint8_t data) override;
+  virtual Status endTransmission() override;
+  virtual uint8_t requestFrom(uint8_t chipAddress, uint8_t count) override;
+  virtual uint8_t read() override;
+  virtual uint8_t getBufferSize() const override;
+  virtual void delay(uint16_t milliseconds) override;
+  virtual uint32_t getMicroseconds() const override;
+
+private:
+  /// @brief The type of a queue entry.
+  ///
+  enum EntryType : uint8_t {
+    EntryTransmission, ///< A transmission: address, size and data.
+    EntryDelay, ///< A delay: 16 bit time in milliseconds.
+    EntryCallback, ///< A callback: function and context pointer.
+  };
+
+  /// @brief Add an entry to the ring buffer, wait for space if required.
+  ///
+  /// @return `true` if the entry was added, `false` if the entry can never
+  ///   fit into the buffer. In this case the queue is empty.
+  ///
+  bool addEntry(EntryType type, const uint8_t *header, uint8_t headerSize, const uint8_t *data, uint8_t dataSize);
+
+  /// @brief Process the next entry.
+  ///
+  /// @param currentTime The current time, used to start a delay.
+  /// @param isBlocking True to wait for delays using the target bus.
+  ///
+  void processEntry(uint32_t currentTime, bool isBlocking);
+
+  /// @brief Add a byte to the ring buffer.
+  ///
+  void pushByte(uint8_t data);
+
+  /// @brief Remove a byte from the ring buffer.
+  ///
+  uint8_t popByte();
+
+private:
+  AS1130Bus *_bus; ///< The target bus.
+  uint8_t *_buffer; ///< The ring buffer.
+  uint16_t _bufferSize; ///< The size of the ring buffer.
+  uint16_t _head; ///< The read position in the ring buffer.
+  uint16_t _used; ///< The number of used bytes in the ring buffer.
+  bool _isDelayActive; ///< If a queued delay is active.
+  uint16_t _delayDuration; ///< The duration of the active delay.
+  uint32_t _delayStartTime; ///< The start time of the active delay.
+  Status _lastError; ///< The last error since the previous callback.
+  uint8_t _chipAddress; ///< The address for the current transmission.
+  uint8_t _transmissionSize; ///< The number of bytes in the current transmission.
+  uint8_t _transmission[cMaximumTransmissionSize]; ///< The current transmission.
+};
+
+
+}
+
+
@@ -0,0 +1,122 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#ifdef ARDUINO
+#include "LRAS1130WireBus.h"
+
+
+#include <Arduino.h>
+
+
+namespace lr {
+
+
+namespace {
+
+
+#if defined(I2C_BUFFER_LENGTH) && I2C_BUFFER_LENGTH < 256
+/// The size of the buffer in the Wire library (ESP32).
+///
+const uint8_t cWireBufferSize = I2C_BUFFER_LENGTH;
+#elif defined(BUFFER_LENGTH) && BUFFER_LENGTH < 256
+/// The size of the buffer in the Wire library.
+///
+const uint8_t cWireBufferSize = BUFFER_LENGTH;
+#else
+/// The size of the buffer in the Wire library.
+///
+const uint8_t cWireBufferSize = 32;
+#endif
+
+/// The bus for the global Wire object.
+///
+AS1130WireBus gDefaultWireBus(Wire);
+
+
+}
+
+
+AS1130WireBus::AS1130WireBus(TwoWire &wire, uint8_t bufferSize)
+  : _wire(wire), _bufferSize(bufferSize != 0 ? bufferSize : cWireBufferSize)
+{
+}
+
+
+AS1130WireBus& AS1130WireBus::getDefault()
+{
+  return gDefaultWireBus;
+}
+
+
+void AS1130WireBus::beginTransmission(uint8_t chipAddress)
+{
+  _wire.beginTransmission(chipAddress);
+}
+
+
+bool AS1130WireBus::write(uint8_t data)
+{
+  if (_wire.write(data) == 0) {
+    _wire.clearWriteError();
+    return false;
+  }
+  return true;
+}
+
+
+AS1130Bus::Status AS1130WireBus::endTransmission()
+{
+  return static_cast<Status>(_wire.endTransmission());
+}
+
+
+uint8_t AS1130WireBus::requestFrom(uint8_t chipAddress, uint8_t count)
+{
+  _wire.requestFrom(chipAddress, count);
+  return static_cast<uint8_t>(_wire.available());
+}
+
+
+uint8_t AS1130WireBus::read()
+{
+  return static_cast<uint8_t>(_wire.read());
+}
+
+
+uint8_t AS1130WireBus::getBufferSize() const
+{
+  return _bufferSize;
+}
+
+
+void AS1130WireBus::delay(uint16_t milliseconds)
+{
+  ::delay(milliseconds);
+}
+
+
+uint32_t AS1130WireBus::getMicroseconds() const
+{
+  return ::micros();
+}
+
+
+}
+
+
+#endif
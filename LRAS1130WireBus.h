@@ -0,0 +1,73 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+#pragma once
+#ifdef ARDUINO
+
+
+#include "LRAS1130Bus.h"
+
+#include <Wire.h>
+
+
+namespace lr {
+
+
+/// @brief The I2C bus implementation using the Arduino Wire library.
+///
+/// By default, all AS1130 instances use a bus on the global `Wire` object.
+/// Create your own instance to use a different `TwoWire` object.
+///
+class AS1130WireBus : public AS1130Bus
+{
+public:
+  /// @brief Create a new bus for the given Wire object.
+  ///
+  /// @param wire The Wire object to use.
+  /// @param bufferSize The size of the transmit buffer of the Wire object. Zero to use
+  ///   the buffer size defined by the Wire library of the platform.
+  ///
+  AS1130WireBus(TwoWire &wire, uint8_t bufferSize = 0);
+
+public:
+  /// @brief Get the bus for the global `Wire` object.
+  ///
+  /// @return The default bus instance.
+  ///
+  static AS1130WireBus& getDefault();
+
+public: // Implement AS1130Bus
+  virtual void beginTransmission(uint8_t chipAddress) override;
+  virtual bool write(uint8_t data) override;
+  virtual Status endTransmission() override;
+  virtual uint8_t requestFrom(uint8_t chipAddress, uint8_t count) override;
+  virtual uint8_t read() override;
+  virtual uint8_t getBufferSize() const override;
+  virtual void delay(uint16_t milliseconds) override;
+  virtual uint32_t getMicroseconds() const override;
+
+private:
+  TwoWire &_wire; ///< The used Wire object.
+  uint8_t _bufferSize; ///< The size of the transmit buffer.
+};
+
+
+}
+
+
+#endif
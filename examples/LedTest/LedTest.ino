@@ -58,12 +58,19 @@ void setup() {
   Serial.println(F("Run the LED test"));
   ledDriver.runManualTest();
 
+  // Read the status of all LEDs at once.
+  uint8_t statusMap[AS1130::cLedStatusMapSize];
+  if (!ledDriver.readLedStatusMap(statusMap)) {
+    Serial.println(F("Could not read the LED status."));
+    return;
+  }
+
   // Display the status of all leds.
   for (uint8_t ledIndex = 0x00; ledIndex < 0xbb; ++ledIndex) {
     Serial.print(F("LED 0x"));
     Serial.print(ledIndex, HEX);
     Serial.print(F(": "));
-    switch (ledDriver.getLedStatus(ledIndex)) {
+    switch (AS1130::getLedStatus(statusMap, ledIndex)) {
       case AS1130::LedStatusOk:
         Serial.println(F(" OK"));
         break;
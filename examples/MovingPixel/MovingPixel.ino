@@ -30,6 +30,9 @@ Picture picture;
 uint8_t positionX = 0;
 uint8_t positionY = 0;
 
+// Keep a copy of the first frame, so only changed bytes are sent.
+uint8_t frameShadow[AS1130FrameData::cSize];
+
 
 void setup() {
   Wire.begin();
@@ -47,6 +50,7 @@ void setup() {
   }
 
   // Set-up everything.
+  ledDriver.setFrameShadow(frameShadow, 1);
   ledDriver.setRamConfiguration(AS1130::RamConfiguration1);
   ledDriver.setOnOffFrameAllOff(0);
   ledDriver.setBlinkAndPwmSetAll(0);
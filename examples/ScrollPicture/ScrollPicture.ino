@@ -25,26 +25,28 @@ using namespace lr;
 AS1130 ledDriver;
 
 
-const uint8_t exampleFrame1[] = {
-  0b11111011, 0b11101111, 0b11111111,
-  0b10001010, 0b00101000, 0b00000001,
-  0b10001010, 0b00101000, 0b00000001,
-  0b10001010, 0b00101000, 0b00000001,
-  0b11111011, 0b11101111, 0b11111111};
+// The frames are converted into register data at compile time
+// and stored in flash memory.
+const AS1130FrameData exampleFrame1 PROGMEM = AS1130FrameData::fromText24x5(
+  "#####.#####.############"
+  "#...#.#...#.#..........#"
+  "#...#.#...#.#..........#"
+  "#...#.#...#.#..........#"
+  "#####.#####.############");
 
-const uint8_t exampleFrame2[] = {
-  0b10000000, 0b10000000, 0b10000000,
-  0b01000001, 0b01000001, 0b01000001,
-  0b00100010, 0b00100010, 0b00100010,
-  0b00010100, 0b00010100, 0b00010100,
-  0b00001000, 0b00001000, 0b00001000};
+const AS1130FrameData exampleFrame2 PROGMEM = AS1130FrameData::fromText24x5(
+  "#.......#.......#......."
+  ".#.....#.#.....#.#.....#"
+  "..#...#...#...#...#...#."
+  "...#.#.....#.#.....#.#.."
+  "....#.......#.......#...");
 
-const uint8_t exampleFrame3[] = {
-  0b00000000, 0b00000000, 0b00000000,
-  0b00000000, 0b00111100, 0b00000000,
-  0b00000000, 0b00100100, 0b00000000,
-  0b00000000, 0b00111100, 0b00000000,
-  0b00000000, 0b00000000, 0b00000000};
+const AS1130FrameData exampleFrame3 PROGMEM = AS1130FrameData::fromText24x5(
+  "........................"
+  "..........####.........."
+  "..........#..#.........."
+  "..........####.........."
+  "........................");
 
 
 void setup() {
@@ -64,10 +66,10 @@ void setup() {
 
   // Set-up everything.
   ledDriver.setRamConfiguration(AS1130::RamConfiguration1);
-  ledDriver.setOnOffFrame24x5(0, exampleFrame1);
-  ledDriver.setOnOffFrame24x5(1, exampleFrame2);
-  ledDriver.setOnOffFrame24x5(2, exampleFrame3);
-  ledDriver.setOnOffFrame24x5(3, exampleFrame2);
+  ledDriver.setOnOffFrameRaw_P(0, &exampleFrame1);
+  ledDriver.setOnOffFrameRaw_P(1, &exampleFrame2);
+  ledDriver.setOnOffFrameRaw_P(2, &exampleFrame3);
+  ledDriver.setOnOffFrameRaw_P(3, &exampleFrame2);
   ledDriver.setBlinkAndPwmSetAll(0);
   ledDriver.setCurrentSource(AS1130::Current30mA);
   ledDriver.setScanLimit(AS1130::ScanLimitFull);
@@ -0,0 +1,627 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+//
+// Benchmark for the bus cost of the high-level operations.
+//
+// This program runs on the host. It runs the main public operations of the
+// AS1130 class (frame, blink and PWM writes, readbacks, configuration and
+// status reads) against a simulated chip and records all transactions with
+// AS1130RecordingBus. For each operation, it reports the number of
+// transactions, the written and read bytes and the estimated time on the
+// bus at 100kHz, 400kHz and 1MHz. The time passed to delay(), e.g. while
+// waiting for a LED test, is reported separately.
+//
+// Build and run from the root of the library:
+//
+//   c++ -std=c++11 -O2 -I. extras/benchmark/BusCost.cpp LRAS1130*.cpp -o BusCost
+//   ./BusCost
+//
+// Options:
+//
+//   --csv            Write the results as CSV instead of a table.
+//   --compare FILE   Compare the results with a CSV file written with --csv.
+//                    Returns 1 if any operation needs more transactions or
+//                    more bytes on the wire than before.
+//
+// Example to catch regressions:
+//
+//   ./BusCost --csv > baseline.csv
+//   # ... change the library ...
+//   ./BusCost --compare baseline.csv
+//
+#include "LRAS1130.h"
+#include "LRAS1130RecordingBus.h"
+#include "LRAS1130Simulator.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+
+using namespace lr;
+
+
+namespace {
+
+
+/// The bus frequencies for the time estimation.
+///
+const uint32_t cBusFrequencies[] = {100000, 400000, 1000000};
+
+/// The number of bus frequencies.
+///
+const uint8_t cBusFrequencyCount = sizeof(cBusFrequencies) / sizeof(cBusFrequencies[0]);
+
+/// The maximum length of an operation name.
+///
+const uint8_t cNameSize = 64;
+
+
+/// The frame from the DisplayPicture example.
+///
+const uint8_t cExampleFrame24x5[] = {
+  0b11111011, 0b11101111, 0b11111111,
+  0b10001010, 0b00101000, 0b00000001,
+  0b10001010, 0b00101000, 0b00000001,
+  0b10001010, 0b00101000, 0b00000001,
+  0b11111011, 0b11101111, 0b11111111};
+
+
+/// The frame from the DisplayPicture example as precomputed register data.
+///
+const AS1130FrameData cExampleFrameData = AS1130FrameData::from24x5(cExampleFrame24x5);
+
+
+/// The measured cost of one operation.
+///
+struct Result {
+  char name[cNameSize]; ///< The name of the operation.
+  unsigned long transactionCount; ///< The number of transactions.
+  unsigned long writtenByteCount; ///< The number of written data bytes.
+  unsigned long readByteCount; ///< The number of read data bytes.
+  unsigned long wireByteCount; ///< The number of bytes on the wire, including the chip address.
+  unsigned long delayTime; ///< The time passed to delay() in milliseconds.
+};
+
+
+/// The signature of a benchmark function.
+///
+typedef void (*OperationFunction)(AS1130 &chip);
+
+
+/// One benchmark case.
+///
+struct Case {
+  const char *name; ///< The name of the operation.
+  OperationFunction prepare; ///< The preparation, which is not measured, or `nullptr`.
+  OperationFunction operation; ///< The measured operation.
+};
+
+
+/// Estimate the time on the bus.
+///
+/// Each byte takes nine clock cycles, including the acknowledge bit. The
+/// start and stop condition of each transaction are counted as two cycles.
+///
+/// @return The time in microseconds.
+///
+double getBusTime(const Result &result, uint32_t frequency)
+{
+  const double cycles = static_cast<double>(result.wireByteCount) * 9.0 + static_cast<double>(result.transactionCount) * 2.0;
+  return cycles * 1000000.0 / static_cast<double>(frequency);
+}
+
+
+/// Check if the chip is connected.
+///
+void checkConnection(AS1130 &chip)
+{
+  chip.isChipConnected();
+}
+
+
+/// Reset the chip.
+///
+void resetChip(AS1130 &chip)
+{
+  chip.resetChip();
+}
+
+
+/// The initialization sequence from the examples.
+///
+void initializeChip(AS1130 &chip)
+{
+  chip.isChipConnected();
+  chip.setRamConfiguration(AS1130::RamConfiguration1);
+  chip.setOnOffFrame24x5(0, cExampleFrame24x5);
+  chip.setBlinkAndPwmSetAll(0);
+  chip.setCurrentSource(AS1130::Current30mA);
+  chip.setScanLimit(AS1130::ScanLimitFull);
+  chip.startPicture(0);
+  chip.startChip();
+}
+
+
+/// The initialization sequence with enabled control register cache.
+///
+void initializeChipCached(AS1130 &chip)
+{
+  chip.setControlRegisterCacheEnabled(true);
+  initializeChip(chip);
+}
+
+
+/// Reset the chip before the initialization sequence.
+///
+void resetAndInitializeChip(AS1130 &chip)
+{
+  chip.resetChip();
+  initializeChip(chip);
+}
+
+
+/// Reset the chip before the initialization sequence, with enabled control register cache.
+///
+void resetAndInitializeChipCached(AS1130 &chip)
+{
+  chip.setControlRegisterCacheEnabled(true);
+  resetAndInitializeChip(chip);
+}
+
+
+/// Set a 12x11 picture with a diagonal pattern.
+///
+void setOnOffFrame12x11(AS1130 &chip)
+{
+  AS1130Picture12x11 picture;
+  for (uint8_t x = 0; x < AS1130Picture12x11::getWidth(); ++x) {
+    for (uint8_t y = 0; y < AS1130Picture12x11::getHeight(); ++y) {
+      picture.setPixel(x, y, ((x + y) & 1) != 0);
+    }
+  }
+  chip.setOnOffFrame(1, picture);
+}
+
+
+/// Set a 24x5 picture with a diagonal pattern.
+///
+void setOnOffFrame24x5(AS1130 &chip)
+{
+  AS1130Picture24x5 picture;
+  for (uint8_t x = 0; x < AS1130Picture24x5::getWidth(); ++x) {
+    for (uint8_t y = 0; y < AS1130Picture24x5::getHeight(); ++y) {
+      picture.setPixel(x, y, ((x + y) & 1) != 0);
+    }
+  }
+  chip.setOnOffFrame(1, picture);
+}
+
+
+/// Set a frame with precomputed register data.
+///
+void setOnOffFrameRawP(AS1130 &chip)
+{
+  chip.setOnOffFrameRaw_P(1, &cExampleFrameData);
+}
+
+
+/// Fill all 36 frames.
+///
+void setOnOffFrameAll(AS1130 &chip)
+{
+  for (uint8_t i = 0; i < 36; ++i) {
+    chip.setOnOffFrameAllOn(i);
+  }
+}
+
+
+/// Set all blink and PWM values of one set.
+///
+void setBlinkAndPwmSetAll(AS1130 &chip)
+{
+  chip.setBlinkAndPwmSetAll(0, false, 0x80);
+}
+
+
+/// Set the PWM value of every LED, one by one.
+///
+void setPwmValueLoop(AS1130 &chip)
+{
+  for (uint8_t x = 0; x < AS1130Picture12x11::getWidth(); ++x) {
+    for (uint8_t y = 0; y < AS1130Picture12x11::getHeight(); ++y) {
+      chip.setPwmValue(0, AS1130::getLedIndex12x11(x, y), x * 16 + y);
+    }
+  }
+}
+
+
+/// Set the PWM values of every LED at once.
+///
+void setPwmSet(AS1130 &chip)
+{
+  uint8_t pwmData[AS1130::cPwmDataSize];
+  for (uint8_t i = 0; i < AS1130::cPwmDataSize; ++i) {
+    pwmData[i] = i;
+  }
+  chip.setPwmSet(0, pwmData);
+}
+
+
+/// Set the PWM values of every LED of a 12x11 matrix at once.
+///
+void setPwmSet12x11(AS1130 &chip)
+{
+  uint8_t values[132];
+  for (uint8_t i = 0; i < sizeof(values); ++i) {
+    values[i] = i;
+  }
+  chip.setPwmSet12x11(0, values);
+}
+
+
+/// Set the PWM values of every LED of a 24x5 matrix at once.
+///
+void setPwmSet24x5(AS1130 &chip)
+{
+  uint8_t values[120];
+  for (uint8_t i = 0; i < sizeof(values); ++i) {
+    values[i] = i;
+  }
+  chip.setPwmSet24x5(0, values);
+}
+
+
+/// Set the blink bits of a set from register data.
+///
+void setBlinkSetData(AS1130 &chip)
+{
+  uint8_t blinkData[AS1130::cBlinkDataSize];
+  for (uint8_t i = 0; i < AS1130::cBlinkDataSize; ++i) {
+    blinkData[i] = (i & 1) != 0 ? 0x55 : 0xaa;
+  }
+  chip.setBlinkSet(0, blinkData);
+}
+
+
+/// Set the blink bits of a set from a 24x5 picture.
+///
+void setBlinkSetPicture(AS1130 &chip)
+{
+  AS1130Picture24x5 picture;
+  for (uint8_t x = 0; x < AS1130Picture24x5::getWidth(); ++x) {
+    for (uint8_t y = 0; y < AS1130Picture24x5::getHeight(); ++y) {
+      picture.setPixel(x, y, ((x + y) & 1) != 0);
+    }
+  }
+  chip.setBlinkSet(0, picture);
+}
+
+
+/// Set a grayscale frame.
+///
+void setGrayFrame(AS1130 &chip)
+{
+  AS1130GrayPicture12x11 picture;
+  for (uint8_t x = 0; x < AS1130GrayPicture12x11::getWidth(); ++x) {
+    for (uint8_t y = 0; y < AS1130GrayPicture12x11::getHeight(); ++y) {
+      picture.setPixel(x, y, x * 16 + y);
+    }
+  }
+  chip.setGrayFrame(1, picture);
+}
+
+
+/// Set the dot correction.
+///
+void setDotCorrection(AS1130 &chip)
+{
+  const uint8_t data[12] = {0xff, 0xf0, 0xe0, 0xd0, 0xc0, 0xb0, 0xa0, 0x90, 0x80, 0x70, 0x60, 0x50};
+  chip.setDotCorrection(data);
+}
+
+
+/// Prepare and start a movie.
+///
+void startMovie(AS1130 &chip)
+{
+  chip.setMovieFrameCount(4);
+  chip.setFrameDelayMs(100);
+  chip.setMovieLoopCount(AS1130::MovieLoopEndless);
+  chip.startMovie(0);
+}
+
+
+/// The LED test scan from the LedTest example.
+///
+void scanLedsWithMap(AS1130 &chip)
+{
+  chip.runManualTest();
+  uint8_t statusMap[AS1130::cLedStatusMapSize];
+  if (!chip.readLedStatusMap(statusMap)) {
+    return;
+  }
+  uint8_t openCount = 0;
+  for (uint8_t ledIndex = 0x00; ledIndex < 0xbb; ++ledIndex) {
+    if (AS1130::getLedStatus(statusMap, ledIndex) == AS1130::LedStatusOpen) {
+      ++openCount;
+    }
+  }
+  (void)openCount;
+}
+
+
+/// The LED test scan, reading the status of each LED separately.
+///
+void scanLedsOneByOne(AS1130 &chip)
+{
+  chip.runManualTest();
+  uint8_t openCount = 0;
+  for (uint8_t ledIndex = 0x00; ledIndex < 0xbb; ++ledIndex) {
+    if (chip.getLedStatus(ledIndex) == AS1130::LedStatusOpen) {
+      ++openCount;
+    }
+  }
+  (void)openCount;
+}
+
+
+/// Read a frame back from the chip.
+///
+void readOnOffFrame(AS1130 &chip)
+{
+  AS1130FrameData frameData;
+  chip.readOnOffFrame(0, frameData);
+}
+
+
+/// Read the blink bits of a set back from the chip.
+///
+void readBlinkSet(AS1130 &chip)
+{
+  uint8_t blinkData[AS1130::cBlinkDataSize];
+  chip.readBlinkSet(0, blinkData);
+}
+
+
+/// Read the PWM values of a set back from the chip.
+///
+void readPwmSet(AS1130 &chip)
+{
+  uint8_t pwmData[AS1130::cPwmDataSize];
+  chip.readPwmSet(0, pwmData);
+}
+
+
+/// Read all control and status registers.
+///
+void readControlRegisters(AS1130 &chip)
+{
+  uint8_t registerData[AS1130::cControlRegisterCount];
+  chip.readControlRegisters(registerData);
+}
+
+
+/// Read the status with separate calls.
+///
+void readStatusSeparately(AS1130 &chip)
+{
+  chip.isLedTestRunning();
+  chip.isMovieRunning();
+  chip.getDisplayedFrame();
+  chip.getInterruptStatus();
+}
+
+
+/// Read the status as one snapshot.
+///
+void readStatusSnapshot(AS1130 &chip)
+{
+  AS1130::StatusSnapshot snapshot;
+  chip.readStatusSnapshot(snapshot);
+}
+
+
+/// Initialize the chip and read a status snapshot, which is cached.
+///
+void initializeChipAndReadStatus(AS1130 &chip)
+{
+  initializeChip(chip);
+  readStatusSnapshot(chip);
+}
+
+
+/// Get a status snapshot, which is still valid.
+///
+void getStatusSnapshotCached(AS1130 &chip)
+{
+  AS1130::StatusSnapshot snapshot;
+  chip.getStatusSnapshot(snapshot, 0xffffffffUL);
+}
+
+
+/// All benchmark cases.
+///
+const Case cCases[] = {
+  {"isChipConnected", nullptr, &checkConnection},
+  {"init example", nullptr, &initializeChip},
+  {"init example cached", nullptr, &initializeChipCached},
+  {"resetChip", &initializeChip, &resetChip},
+  {"reset and init", nullptr, &resetAndInitializeChip},
+  {"reset and init cached", nullptr, &resetAndInitializeChipCached},
+  {"setOnOffFrame 12x11", &initializeChip, &setOnOffFrame12x11},
+  {"setOnOffFrame 24x5", &initializeChip, &setOnOffFrame24x5},
+  {"setOnOffFrameRaw_P", &initializeChip, &setOnOffFrameRawP},
+  {"setOnOffFrameAllOn x36", &initializeChip, &setOnOffFrameAll},
+  {"setBlinkAndPwmSetAll", &initializeChip, &setBlinkAndPwmSetAll},
+  {"setPwmValue x132", &initializeChip, &setPwmValueLoop},
+  {"setPwmSet", &initializeChip, &setPwmSet},
+  {"setPwmSet12x11", &initializeChip, &setPwmSet12x11},
+  {"setPwmSet24x5", &initializeChip, &setPwmSet24x5},
+  {"setBlinkSet data", &initializeChip, &setBlinkSetData},
+  {"setBlinkSet 24x5", &initializeChip, &setBlinkSetPicture},
+  {"setGrayFrame 12x11", &initializeChip, &setGrayFrame},
+  {"setDotCorrection", &initializeChip, &setDotCorrection},
+  {"start movie", &initializeChip, &startMovie},
+  {"start movie cached", &initializeChipCached, &startMovie},
+  {"LED test scan map", &initializeChip, &scanLedsWithMap},
+  {"LED test scan per LED", &initializeChip, &scanLedsOneByOne},
+  {"status separate", &initializeChip, &readStatusSeparately},
+  {"status snapshot", &initializeChip, &readStatusSnapshot},
+  {"status snapshot cached", &initializeChipAndReadStatus, &getStatusSnapshotCached},
+  {"readOnOffFrame", &initializeChip, &readOnOffFrame},
+  {"readBlinkSet", &initializeChip, &readBlinkSet},
+  {"readPwmSet", &initializeChip, &readPwmSet},
+  {"readControlRegisters", &initializeChip, &readControlRegisters},
+};
+
+/// The number of benchmark cases.
+///
+const uint8_t cCaseCount = sizeof(cCases) / sizeof(cCases[0]);
+
+
+/// Run one benchmark case on a new simulated chip.
+///
+Result runCase(const Case &benchmarkCase)
+{
+  AS1130Simulator simulator;
+  AS1130RecordingBus bus(&simulator);
+  AS1130 chip(bus);
+  if (benchmarkCase.prepare != nullptr) {
+    benchmarkCase.prepare(chip);
+  }
+  bus.clear();
+  benchmarkCase.operation(chip);
+  Result result;
+  std::snprintf(result.name, cNameSize, "%s", benchmarkCase.name);
+  result.transactionCount = static_cast<unsigned long>(bus.getTransactionCount());
+  result.writtenByteCount = static_cast<unsigned long>(bus.getWrittenByteCount());
+  result.readByteCount = static_cast<unsigned long>(bus.getReadByteCount());
+  result.wireByteCount = static_cast<unsigned long>(bus.getWireByteCount());
+  result.delayTime = static_cast<unsigned long>(bus.getDelayTime());
+  return result;
+}
+
+
+/// Write the results as a table.
+///
+void writeTable(const std::vector<Result> &results)
+{
+  std::printf("%-24s %6s %6s %6s %6s %10s %10s %10s %8s\n",
+    "operation", "tx", "write", "read", "wire", "us@100k", "us@400k", "us@1M", "delay_ms");
+  for (const Result &result : results) {
+    std::printf("%-24s %6lu %6lu %6lu %6lu", result.name, result.transactionCount,
+      result.writtenByteCount, result.readByteCount, result.wireByteCount);
+    for (uint8_t i = 0; i < cBusFrequencyCount; ++i) {
+      std::printf(" %10.1f", getBusTime(result, cBusFrequencies[i]));
+    }
+    std::printf(" %8lu\n", result.delayTime);
+  }
+}
+
+
+/// Write the results as CSV.
+///
+void writeCsv(const std::vector<Result> &results)
+{
+  std::printf("operation,transactions,written_bytes,read_bytes,wire_bytes,us_100khz,us_400khz,us_1mhz,delay_ms\n");
+  for (const Result &result : results) {
+    std::printf("%s,%lu,%lu,%lu,%lu", result.name, result.transactionCount,
+      result.writtenByteCount, result.readByteCount, result.wireByteCount);
+    for (uint8_t i = 0; i < cBusFrequencyCount; ++i) {
+      std::printf(",%.1f", getBusTime(result, cBusFrequencies[i]));
+    }
+    std::printf(",%lu\n", result.delayTime);
+  }
+}
+
+
+/// Compare the results with a CSV file.
+///
+/// @return The number of regressions, or -1 if the file can not be read.
+///
+int compareWithCsv(const std::vector<Result> &results, const char *path)
+{
+  std::FILE *file = std::fopen(path, "r");
+  if (file == nullptr) {
+    std::fprintf(stderr, "Could not open %s.\n", path);
+    return -1;
+  }
+  int regressionCount = 0;
+  char line[256];
+  while (std::fgets(line, sizeof(line), file) != nullptr) {
+    Result baseline;
+    if (std::sscanf(line, "%63[^,],%lu,%lu,%lu,%lu", baseline.name, &baseline.transactionCount,
+        &baseline.writtenByteCount, &baseline.readByteCount, &baseline.wireByteCount) != 5) {
+      continue; // The header or an invalid line.
+    }
+    for (const Result &result : results) {
+      if (std::strcmp(result.name, baseline.name) != 0) {
+        continue;
+      }
+      if (result.transactionCount > baseline.transactionCount || result.wireByteCount > baseline.wireByteCount) {
+        std::printf("REGRESSION %s: tx %lu -> %lu, wire bytes %lu -> %lu\n", result.name,
+          baseline.transactionCount, result.transactionCount, baseline.wireByteCount, result.wireByteCount);
+        ++regressionCount;
+      }
+    }
+  }
+  std::fclose(file);
+  return regressionCount;
+}
+
+
+}
+
+
+int main(int argc, char *argv[])
+{
+  bool isCsv = false;
+  const char *comparePath = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--csv") == 0) {
+      isCsv = true;
+    } else if (std::strcmp(argv[i], "--compare") == 0 && i + 1 < argc) {
+      comparePath = argv[++i];
+    } else {
+      std::fprintf(stderr, "Usage: %s [--csv] [--compare FILE]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  std::vector<Result> results;
+  for (uint8_t i = 0; i < cCaseCount; ++i) {
+    results.push_back(runCase(cCases[i]));
+  }
+
+  if (isCsv) {
+    writeCsv(results);
+  } else {
+    writeTable(results);
+  }
+
+  if (comparePath != nullptr) {
+    const int regressionCount = compareWithCsv(results, comparePath);
+    if (regressionCount != 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
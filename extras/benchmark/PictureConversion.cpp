@@ -0,0 +1,164 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+//
+// Micro benchmark for the conversion of pictures into register data.
+//
+// This program runs on the host and compares the per-pixel conversion used
+// in earlier versions of the library with the current implementation. It
+// reports the time stamp counter cycles (on x86) and nanoseconds per
+// conversion, and checks if both conversions produce identical data.
+//
+// Build and run from the root of the library:
+//
+//   c++ -std=c++11 -O2 -I. extras/benchmark/PictureConversion.cpp LRAS1130*.cpp -o PictureConversion
+//   ./PictureConversion
+//
+#include "LRAS1130.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+using namespace lr;
+
+
+namespace {
+
+
+/// The number of pictures to convert.
+///
+const uint32_t cPictureCount = 256;
+
+/// The number of runs over all pictures.
+///
+const uint32_t cRunCount = 2000;
+
+
+/// The per-pixel conversion for 12x11 pictures.
+///
+void writeRegistersPerPixel12x11(uint8_t *registerData, const uint8_t *rawData, uint8_t pwmSetIndex)
+{
+  std::memset(registerData, 0, 0x18);
+  for (uint8_t x = 0; x < AS1130Picture12x11::getWidth(); ++x) {
+    for (uint8_t y = 0; y < AS1130Picture12x11::getHeight(); ++y) {
+      if ((rawData[AS1130Picture12x11::getDataIndex(x, y)] & AS1130Picture12x11::getDataBit(x,y)) != 0) {
+        registerData[(x*2)+(y/8)] |= (1<<(y&7));
+      }
+    }
+  }
+  registerData[1] |= (pwmSetIndex<<5);
+}
+
+
+/// The per-pixel conversion for 24x5 pictures.
+///
+void writeRegistersPerPixel24x5(uint8_t *registerData, const uint8_t *rawData, uint8_t pwmSetIndex)
+{
+  std::memset(registerData, 0, 0x18);
+  for (uint8_t x = 0; x < AS1130Picture24x5::getWidth(); ++x) {
+    for (uint8_t y = 0; y < AS1130Picture24x5::getHeight(); ++y) {
+      if ((rawData[AS1130Picture24x5::getDataIndex(x, y)] & AS1130Picture24x5::getDataBit(x,y)) != 0) {
+        const uint8_t ledIndex = (x*5+y);
+        const uint8_t registerBitIndex = ledIndex%10;
+        uint8_t registerIndex = (ledIndex/10)*2+(registerBitIndex/8);
+        registerData[registerIndex] |= (1<<(registerBitIndex&7));
+      }
+    }
+  }
+  registerData[1] |= (pwmSetIndex<<5);
+}
+
+
+/// The signature of a conversion function.
+///
+typedef void (*ConversionFunction)(uint8_t *registerData, const uint8_t *rawData, uint8_t pwmSetIndex);
+
+
+/// Read the cycle counter.
+///
+inline uint64_t readCycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+
+/// Run one conversion function over all pictures and print the result.
+///
+void benchmark(const char *name, ConversionFunction function, const uint8_t *pictures, uint8_t pictureSize, uint8_t *checksum)
+{
+  uint8_t registerData[0x18];
+  std::memset(checksum, 0, 0x18);
+  const auto startTime = std::chrono::steady_clock::now();
+  const uint64_t startCycles = readCycles();
+  for (uint32_t run = 0; run < cRunCount; ++run) {
+    for (uint32_t i = 0; i < cPictureCount; ++i) {
+      function(registerData, pictures + (i * pictureSize), static_cast<uint8_t>(i & 7));
+      for (uint8_t j = 0; j < 0x18; ++j) {
+        checksum[j] ^= registerData[j];
+      }
+    }
+  }
+  const uint64_t cycles = readCycles() - startCycles;
+  const auto duration = std::chrono::steady_clock::now() - startTime;
+  const double conversionCount = static_cast<double>(cRunCount) * cPictureCount;
+  const double nanoseconds = std::chrono::duration<double, std::nano>(duration).count();
+  std::printf("%-16s %10.1f cycles %10.1f ns per conversion\n", name,
+    static_cast<double>(cycles) / conversionCount, nanoseconds / conversionCount);
+}
+
+
+}
+
+
+int main()
+{
+  uint8_t pictures[cPictureCount * 17];
+  std::srand(1);
+  for (uint32_t i = 0; i < sizeof(pictures); ++i) {
+    pictures[i] = static_cast<uint8_t>(std::rand());
+  }
+  uint8_t checksumPerPixel[0x18];
+  uint8_t checksumLibrary[0x18];
+  bool isEqual = true;
+
+  benchmark("12x11 per pixel", &writeRegistersPerPixel12x11, pictures, 17, checksumPerPixel);
+  benchmark("12x11 library", &AS1130Picture12x11::writeRegisters, pictures, 17, checksumLibrary);
+  isEqual &= (std::memcmp(checksumPerPixel, checksumLibrary, 0x18) == 0);
+
+  benchmark("24x5 per pixel", &writeRegistersPerPixel24x5, pictures, 15, checksumPerPixel);
+  benchmark("24x5 library", &AS1130Picture24x5::writeRegisters, pictures, 15, checksumLibrary);
+  isEqual &= (std::memcmp(checksumPerPixel, checksumLibrary, 0x18) == 0);
+
+  if (!isEqual) {
+    std::printf("ERROR: The register data of the conversions differ.\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,417 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+//
+// Fault injection test for the error handling of the AS1130 class.
+//
+// This program runs on the host. It connects an AS1130 instance through a
+// faulty bus to a simulated chip. The faulty bus lets a given percentage
+// of the transactions fail. A failed write either reaches the chip not at
+// all (address NACK) or only partially (data NACK). It checks:
+//
+// - Without retries, every frame upload which did not reach the chip
+//   completely is reported by getLastError(). There is no silent corruption.
+// - Repeating a failed upload restores the frame on the chip.
+// - With retries, all frame uploads succeed.
+// - A failed upload never changes other frames or other register banks.
+// - With a frame shadow, after a failed upload only the affected frame
+//   is sent again, and it is sent completely.
+//
+// Build and run from the root of the library:
+//
+//   c++ -std=c++11 -O2 -I. extras/test/BusErrorRecoveryTest.cpp LRAS1130*.cpp -o BusErrorRecoveryTest
+//   ./BusErrorRecoveryTest
+//
+#include "LRAS1130.h"
+#include "LRAS1130RecordingBus.h"
+#include "LRAS1130Simulator.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+
+using namespace lr;
+
+
+namespace {
+
+
+/// The percentage of failed transactions.
+///
+const uint8_t cFailurePercent = 10;
+
+/// The number of frame uploads for each test.
+///
+const uint32_t cUploadCount = 500;
+
+/// The number of retries for the test with retries.
+///
+const uint8_t cRetryCount = 3;
+
+/// The maximum number of repeats for a failed upload.
+///
+const uint8_t cMaximumRepeatCount = 20;
+
+/// The number of frames of the chip.
+///
+const uint8_t cFrameCount = 36;
+
+/// The number of failed checks.
+///
+uint32_t gFailureCount = 0;
+
+
+/// Check a condition and report a failure.
+///
+void check(bool condition, const char *description)
+{
+  std::printf("%s %s\n", condition ? "ok    " : "FAILED", description);
+  if (!condition) {
+    ++gFailureCount;
+  }
+}
+
+
+/// A bus which lets transactions fail.
+///
+class FaultyBus : public AS1130Bus
+{
+public:
+  /// Create a new faulty bus.
+  ///
+  FaultyBus(AS1130Bus &target, uint8_t failurePercent)
+    : _target(&target),
+      _failurePercent(failurePercent),
+      _transactionCount(0),
+      _failureCount(0),
+      _forcedFailureIndex(0),
+      _isFailureForced(false),
+      _chipAddress(0),
+      _transmissionSize(0)
+  {
+  }
+
+  /// Set the percentage of failed transactions.
+  ///
+  void setFailurePercent(uint8_t failurePercent) { _failurePercent = failurePercent; }
+
+  /// Let one of the next transactions fail.
+  ///
+  /// @param index The index of the transaction, counted from the next one.
+  ///
+  void failTransaction(uint32_t index)
+  {
+    _forcedFailureIndex = _transactionCount + index;
+    _isFailureForced = true;
+  }
+
+  /// Get the number of failed transactions.
+  ///
+  uint32_t getFailureCount() const { return _failureCount; }
+
+public: // Implement AS1130Bus
+  virtual void beginTransmission(uint8_t chipAddress) override
+  {
+    _chipAddress = chipAddress;
+    _transmissionSize = 0;
+  }
+
+  virtual bool write(uint8_t data) override
+  {
+    if (_transmissionSize >= sizeof(_transmission)) {
+      return false;
+    }
+    _transmission[_transmissionSize] = data;
+    ++_transmissionSize;
+    return true;
+  }
+
+  virtual Status endTransmission() override
+  {
+    uint8_t sentSize = _transmissionSize;
+    Status status = StatusSuccess;
+    if (isFailure()) {
+      if ((std::rand() & 1) == 0) {
+        // The chip does not respond, nothing reaches the chip.
+        sentSize = 0;
+        status = StatusAddressNack;
+      } else {
+        // The transmission breaks after a random number of bytes.
+        sentSize = static_cast<uint8_t>(1 + std::rand() % _transmissionSize);
+        status = StatusDataNack;
+      }
+    }
+    if (sentSize > 0) {
+      _target->beginTransmission(_chipAddress);
+      for (uint8_t i = 0; i < sentSize; ++i) {
+        _target->write(_transmission[i]);
+      }
+      _target->endTransmission();
+    }
+    return status;
+  }
+
+  virtual uint8_t requestFrom(uint8_t chipAddress, uint8_t count) override
+  {
+    if (isFailure()) {
+      return 0;
+    }
+    return _target->requestFrom(chipAddress, count);
+  }
+
+  virtual uint8_t read() override { return _target->read(); }
+  virtual uint8_t getBufferSize() const override { return sizeof(_transmission); }
+  virtual void delay(uint16_t milliseconds) override { _target->delay(milliseconds); }
+  virtual uint32_t getMicroseconds() const override { return _target->getMicroseconds(); }
+
+private:
+  /// Count a transaction and decide if it fails.
+  ///
+  bool isFailure()
+  {
+    bool isFailure = (static_cast<uint8_t>(std::rand() % 100) < _failurePercent);
+    if (_isFailureForced && _transactionCount == _forcedFailureIndex) {
+      isFailure = true;
+      _isFailureForced = false;
+    }
+    ++_transactionCount;
+    if (isFailure) {
+      ++_failureCount;
+    }
+    return isFailure;
+  }
+
+private:
+  AS1130Bus *_target; ///< The bus to the chip.
+  uint8_t _failurePercent; ///< The percentage of failed transactions.
+  uint32_t _transactionCount; ///< The number of transactions.
+  uint32_t _failureCount; ///< The number of failed transactions.
+  uint32_t _forcedFailureIndex; ///< The index of the transaction which has to fail.
+  bool _isFailureForced; ///< If a transaction has to fail.
+  uint8_t _chipAddress; ///< The address for the current transmission.
+  uint8_t _transmissionSize; ///< The number of bytes in the current transmission.
+  uint8_t _transmission[32]; ///< The current transmission.
+};
+
+
+/// Fill frame data with random bytes.
+///
+void setRandomFrame(AS1130FrameData &frameData)
+{
+  for (uint8_t i = 0; i < AS1130FrameData::cSize; ++i) {
+    frameData.registers[i] = static_cast<uint8_t>(std::rand());
+  }
+}
+
+
+/// Check if a frame on the chip matches the given data.
+///
+bool isFrameOnChip(const AS1130Simulator &simulator, uint8_t frameIndex, const AS1130FrameData &frameData)
+{
+  for (uint8_t i = 0; i < AS1130FrameData::cSize; ++i) {
+    if (simulator.getMemory(AS1130::RS_OnOffFrame + frameIndex, i) != frameData.registers[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/// Check if the blink and PWM sets, the dot correction and the control registers are unchanged.
+///
+/// The test writes frames only, so all other banks keep their power-on value of zero.
+///
+bool areOtherBanksUnchanged(const AS1130Simulator &simulator)
+{
+  for (uint16_t address = 0; address < 0x100; ++address) {
+    for (uint8_t set = 0; set < 6; ++set) {
+      if (simulator.getMemory(AS1130::RS_BlinkAndPwmSet + set, static_cast<uint8_t>(address)) != 0) {
+        return false;
+      }
+    }
+    if (simulator.getMemory(AS1130::RS_DotCorrection, static_cast<uint8_t>(address)) != 0) {
+      return false;
+    }
+    if (address < 0x0c && simulator.getMemory(AS1130::RS_Control, static_cast<uint8_t>(address)) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/// Upload random frames through a faulty bus.
+///
+/// Failed uploads are repeated until they succeed, like an application
+/// which checks getLastError() would do.
+///
+void testFrameUploads(uint8_t retryCount)
+{
+  std::srand(7);
+  AS1130Simulator simulator;
+  FaultyBus faultyBus(simulator, cFailurePercent);
+  AS1130 ledDriver(faultyBus);
+  uint8_t frameShadow[cFrameCount * AS1130FrameData::cSize];
+  ledDriver.setFrameShadow(frameShadow, cFrameCount);
+  ledDriver.setRetryCount(retryCount);
+
+  AS1130FrameData expectedFrames[cFrameCount] = {};
+  bool isFrameKnown[cFrameCount];
+  for (uint8_t i = 0; i < cFrameCount; ++i) {
+    isFrameKnown[i] = true;
+  }
+  uint32_t reportedCount = 0;
+  uint32_t silentCount = 0;
+  uint32_t unrecoveredCount = 0;
+  uint32_t otherFrameChangeCount = 0;
+  for (uint32_t upload = 0; upload < cUploadCount; ++upload) {
+    const uint8_t frameIndex = static_cast<uint8_t>(std::rand() % cFrameCount);
+    setRandomFrame(expectedFrames[frameIndex]);
+    bool isUploaded = false;
+    for (uint8_t repeat = 0; repeat < cMaximumRepeatCount && !isUploaded; ++repeat) {
+      ledDriver.clearLastError();
+      ledDriver.setOnOffFrameRaw(frameIndex, expectedFrames[frameIndex]);
+      if (ledDriver.getLastError() != AS1130Bus::StatusSuccess) {
+        ++reportedCount;
+      } else if (!isFrameOnChip(simulator, frameIndex, expectedFrames[frameIndex])) {
+        ++silentCount;
+        break;
+      } else {
+        isUploaded = true;
+      }
+    }
+    if (!isUploaded) {
+      // The content of the frame on the chip is unknown.
+      ++unrecoveredCount;
+    }
+    isFrameKnown[frameIndex] = isUploaded;
+    for (uint8_t i = 0; i < cFrameCount; ++i) {
+      if (i != frameIndex && isFrameKnown[i] && !isFrameOnChip(simulator, i, expectedFrames[i])) {
+        ++otherFrameChangeCount;
+      }
+    }
+  }
+  std::printf("       retries=%u: %lu failed transactions, %lu reported uploads, %lu silent corruptions\n",
+    retryCount, static_cast<unsigned long>(faultyBus.getFailureCount()),
+    static_cast<unsigned long>(reportedCount), static_cast<unsigned long>(silentCount));
+  check(faultyBus.getFailureCount() > 0, "transactions failed");
+  check(silentCount == 0, "every failed upload is reported");
+  check(unrecoveredCount == 0, "repeating a failed upload restores the frame");
+  check(otherFrameChangeCount == 0, "a failed upload does not change other frames");
+  check(areOtherBanksUnchanged(simulator), "a failed upload does not change other register banks");
+  if (retryCount == 0) {
+    check(reportedCount > 0, "failures are reported without retries");
+  } else {
+    check(reportedCount == 0, "all uploads succeed with retries");
+  }
+}
+
+
+/// Let one transaction of a frame upload fail and upload all frames again.
+///
+/// With the frame shadow, only the affected frame is sent again.
+///
+void testResendAfterFailure(uint32_t failedTransactionIndex)
+{
+  std::srand(11);
+  AS1130Simulator simulator;
+  AS1130RecordingBus recordingBus(&simulator);
+  FaultyBus faultyBus(recordingBus, 0);
+  AS1130 ledDriver(faultyBus);
+  uint8_t frameShadow[cFrameCount * AS1130FrameData::cSize];
+  ledDriver.setFrameShadow(frameShadow, cFrameCount);
+  AS1130FrameData frames[cFrameCount];
+  for (uint8_t i = 0; i < cFrameCount; ++i) {
+    setRandomFrame(frames[i]);
+    ledDriver.setOnOffFrameRaw(i, frames[i]);
+  }
+  const uint8_t affectedFrame = 5;
+  setRandomFrame(frames[affectedFrame]);
+  faultyBus.failTransaction(failedTransactionIndex);
+  ledDriver.clearLastError();
+  ledDriver.setOnOffFrameRaw(affectedFrame, frames[affectedFrame]);
+  const bool isFailed = (ledDriver.getLastError() != AS1130Bus::StatusSuccess);
+
+  recordingBus.clear();
+  ledDriver.clearLastError();
+  for (uint8_t i = 0; i < cFrameCount; ++i) {
+    ledDriver.setOnOffFrameRaw(i, frames[i]);
+  }
+  bool isOnlyAffectedFrameSent = true;
+  uint32_t frameByteCount = 0;
+  uint8_t registerSelection = AS1130::RS_OnOffFrame + affectedFrame;
+  for (const AS1130RecordingBus::Transaction &transaction : recordingBus.getTransactions()) {
+    if (transaction.data.size() == 2 && transaction.data[0] == 0xfd) {
+      registerSelection = transaction.data[1];
+    } else if (!transaction.data.empty()) {
+      frameByteCount += static_cast<uint32_t>(transaction.data.size() - 1);
+    }
+    if (registerSelection != AS1130::RS_OnOffFrame + affectedFrame) {
+      isOnlyAffectedFrameSent = false;
+    }
+  }
+  char description[96];
+  std::snprintf(description, sizeof(description), "failed transaction %lu: only the affected frame is sent again",
+    static_cast<unsigned long>(failedTransactionIndex));
+  check(isFailed && isOnlyAffectedFrameSent, description);
+  std::snprintf(description, sizeof(description), "failed transaction %lu: the affected frame is sent completely",
+    static_cast<unsigned long>(failedTransactionIndex));
+  check(frameByteCount == AS1130FrameData::cSize, description);
+  bool areFramesOnChip = (ledDriver.getLastError() == AS1130Bus::StatusSuccess);
+  for (uint8_t i = 0; i < cFrameCount; ++i) {
+    areFramesOnChip &= isFrameOnChip(simulator, i, frames[i]);
+  }
+  std::snprintf(description, sizeof(description), "failed transaction %lu: all frames are on the chip",
+    static_cast<unsigned long>(failedTransactionIndex));
+  check(areFramesOnChip, description);
+}
+
+
+/// Write a chunk which does not fit into the buffer of the bus.
+///
+void testChunkTooLarge()
+{
+  AS1130Simulator simulator;
+  AS1130RecordingBus recordingBus(&simulator, 1);
+  AS1130 ledDriver(recordingBus);
+  AS1130FrameData frameData;
+  setRandomFrame(frameData);
+  ledDriver.setOnOffFrameRaw(0, frameData);
+  check(ledDriver.getLastError() == AS1130Bus::StatusDataTooLong, "a chunk larger than the bus buffer is reported");
+  check(recordingBus.getTransactionCount() == 0, "a chunk larger than the bus buffer is not sent");
+}
+
+
+}
+
+
+int main()
+{
+  testFrameUploads(0);
+  testFrameUploads(cRetryCount);
+  // A full frame upload is a register selection and one data transaction.
+  testResendAfterFailure(0);
+  testResendAfterFailure(1);
+  testChunkTooLarge();
+  if (gFailureCount != 0) {
+    std::printf("FAILED\n");
+    return 1;
+  }
+  std::printf("OK\n");
+  return 0;
+}
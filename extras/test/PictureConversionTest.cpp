@@ -0,0 +1,191 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+//
+// Equivalence test for the conversion of pictures into register data.
+//
+// This program runs on the host. It compares the register data created by
+// AS1130Picture12x11::writeRegisters() and AS1130Picture24x5::writeRegisters()
+// byte by byte with a per-pixel reference, which places each pixel at the
+// LED index from AS1130::getLedIndex12x11() or AS1130::getLedIndex24x5().
+//
+// It tests every picture with a single pixel, combined with all 8 PWM set
+// indexes, and a number of random pictures.
+//
+// Note: the per-pixel conversion in earlier versions of the library used the
+// column (`x&7`) instead of the row (`y&7`) as bit index for 12x11 pictures.
+// This was a bug, the written bits did not match the LED index layout of
+// the chip. The reference in this test uses the LED index, so the current
+// conversion is not identical to the old one for 12x11 pictures.
+//
+// Build and run from the root of the library:
+//
+//   c++ -std=c++11 -O2 -I. extras/test/PictureConversionTest.cpp LRAS1130*.cpp -o PictureConversionTest
+//   ./PictureConversionTest
+//
+#include "LRAS1130.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+using namespace lr;
+
+
+namespace {
+
+
+/// The number of random pictures for each picture type.
+///
+const uint32_t cRandomPictureCount = 100000;
+
+/// The size of the register data.
+///
+const uint8_t cRegisterDataSize = 0x18;
+
+
+/// Set the bit for a LED index in the register data.
+///
+void setLedBit(uint8_t *registerData, uint8_t ledIndex)
+{
+  const uint8_t segment = (ledIndex >> 4);
+  const uint8_t led = (ledIndex & 0xf);
+  registerData[segment * 2 + (led >> 3)] |= (1 << (led & 7));
+}
+
+
+/// Create the reference register data for a 12x11 picture.
+///
+void writeReference(uint8_t *registerData, AS1130Picture12x11 &picture, uint8_t pwmSetIndex)
+{
+  std::memset(registerData, 0, cRegisterDataSize);
+  for (uint8_t x = 0; x < AS1130Picture12x11::getWidth(); ++x) {
+    for (uint8_t y = 0; y < AS1130Picture12x11::getHeight(); ++y) {
+      if (picture.getPixel(x, y)) {
+        setLedBit(registerData, AS1130::getLedIndex12x11(x, y));
+      }
+    }
+  }
+  registerData[1] |= (pwmSetIndex << 5);
+}
+
+
+/// Create the reference register data for a 24x5 picture.
+///
+void writeReference(uint8_t *registerData, AS1130Picture24x5 &picture, uint8_t pwmSetIndex)
+{
+  std::memset(registerData, 0, cRegisterDataSize);
+  for (uint8_t x = 0; x < AS1130Picture24x5::getWidth(); ++x) {
+    for (uint8_t y = 0; y < AS1130Picture24x5::getHeight(); ++y) {
+      if (picture.getPixel(x, y)) {
+        setLedBit(registerData, AS1130::getLedIndex24x5(x, y));
+      }
+    }
+  }
+  registerData[1] |= (pwmSetIndex << 5);
+}
+
+
+/// Compare the conversion of one picture with the reference.
+///
+/// @return `true` if the register data is identical.
+///
+template<typename Picture>
+bool comparePicture(Picture &picture, uint8_t pwmSetIndex, const char *description)
+{
+  uint8_t expected[cRegisterDataSize];
+  uint8_t actual[cRegisterDataSize];
+  writeReference(expected, picture, pwmSetIndex);
+  std::memset(actual, 0xaa, cRegisterDataSize);
+  Picture::writeRegisters(actual, picture.getData(), pwmSetIndex);
+  if (std::memcmp(expected, actual, cRegisterDataSize) == 0) {
+    return true;
+  }
+  std::printf("MISMATCH %s, PWM set %u:\n  expected:", description, pwmSetIndex);
+  for (uint8_t i = 0; i < cRegisterDataSize; ++i) {
+    std::printf(" %02x", expected[i]);
+  }
+  std::printf("\n  actual:  ");
+  for (uint8_t i = 0; i < cRegisterDataSize; ++i) {
+    std::printf(" %02x", actual[i]);
+  }
+  std::printf("\n");
+  return false;
+}
+
+
+/// Test all single pixel pictures and random pictures of one type.
+///
+/// @return The number of mismatches.
+///
+template<typename Picture>
+uint32_t testPictureType(const char *name)
+{
+  uint32_t mismatchCount = 0;
+  uint32_t testCount = 0;
+  char description[64];
+  for (uint8_t x = 0; x < Picture::getWidth(); ++x) {
+    for (uint8_t y = 0; y < Picture::getHeight(); ++y) {
+      Picture picture;
+      picture.setPixel(x, y, true);
+      for (uint8_t pwmSetIndex = 0; pwmSetIndex < 8; ++pwmSetIndex) {
+        std::snprintf(description, sizeof(description), "%s pixel %u/%u", name, x, y);
+        if (!comparePicture(picture, pwmSetIndex, description)) {
+          ++mismatchCount;
+        }
+        ++testCount;
+      }
+    }
+  }
+  for (uint32_t i = 0; i < cRandomPictureCount; ++i) {
+    Picture picture;
+    for (uint8_t x = 0; x < Picture::getWidth(); ++x) {
+      for (uint8_t y = 0; y < Picture::getHeight(); ++y) {
+        picture.setPixel(x, y, (std::rand() & 1) != 0);
+      }
+    }
+    std::snprintf(description, sizeof(description), "%s random picture %lu", name, static_cast<unsigned long>(i));
+    if (!comparePicture(picture, static_cast<uint8_t>(i & 7), description)) {
+      ++mismatchCount;
+    }
+    ++testCount;
+  }
+  std::printf("%-6s %lu pictures, %lu mismatches\n", name,
+    static_cast<unsigned long>(testCount), static_cast<unsigned long>(mismatchCount));
+  return mismatchCount;
+}
+
+
+}
+
+
+int main()
+{
+  std::srand(1);
+  uint32_t mismatchCount = 0;
+  mismatchCount += testPictureType<AS1130Picture12x11>("12x11");
+  mismatchCount += testPictureType<AS1130Picture24x5>("24x5");
+  if (mismatchCount != 0) {
+    std::printf("FAILED\n");
+    return 1;
+  }
+  std::printf("OK\n");
+  return 0;
+}
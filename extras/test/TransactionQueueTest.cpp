@@ -0,0 +1,316 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+//
+// Scheduling test for the transaction queue.
+//
+// This program runs on the host. It connects an AS1130 instance through an
+// AS1130TransactionQueue to a simulated chip and polls the queue with a
+// simulated millisecond clock. It checks:
+//
+// - Resetting and configuring the chip with the control register cache
+//   enabled returns at once, without any transaction on the bus.
+// - poll() sends at most one transmission for each call.
+// - The delay queued by resetChip() is honoured: the first transmission
+//   after the reset is sent when the delay has passed, and not earlier.
+// - The callback is called after all transmissions and reports success.
+// - The chip shows the expected picture after the queue is empty.
+// - After a failed deferred frame write, the callback resets the state of
+//   the chip instance with AS1130::invalidateChipState(), and writing the
+//   frame again restores it on the chip.
+// - A transmission which can never fit into the queue buffer is rejected
+//   with StatusDataTooLong and nothing is sent.
+//
+// Build and run from the root of the library:
+//
+//   c++ -std=c++11 -O2 -I. extras/test/TransactionQueueTest.cpp LRAS1130*.cpp -o TransactionQueueTest
+//   ./TransactionQueueTest
+//
+#include "LRAS1130.h"
+#include "LRAS1130RecordingBus.h"
+#include "LRAS1130Simulator.h"
+#include "LRAS1130TransactionQueue.h"
+
+#include <cstdio>
+#include <vector>
+
+
+using namespace lr;
+
+
+namespace {
+
+
+/// The delay of resetChip() in milliseconds.
+///
+const uint32_t cResetDelay = 100;
+
+/// The maximum number of polls before the test gives up.
+///
+const uint32_t cMaximumPollCount = 10000;
+
+/// The number of failed checks.
+///
+uint32_t gFailureCount = 0;
+
+
+/// Check a condition and report a failure.
+///
+void check(bool condition, const char *description)
+{
+  std::printf("%s %s\n", condition ? "ok    " : "FAILED", description);
+  if (!condition) {
+    ++gFailureCount;
+  }
+}
+
+
+/// The state of the callback.
+///
+struct CallbackState {
+  bool isCalled; ///< If the callback was called.
+  AS1130Bus::Status status; ///< The reported status.
+  std::size_t transactionCount; ///< The number of transactions at the time of the call.
+  AS1130RecordingBus *recordingBus; ///< The bus to count the transactions.
+  AS1130 *ledDriver; ///< The chip instance which uses the queue.
+};
+
+
+/// A bus which can be disconnected from the chip.
+///
+class DisconnectableBus : public AS1130Bus
+{
+public:
+  /// Create a new bus, which is connected to the target.
+  ///
+  explicit DisconnectableBus(AS1130Bus &target) : _target(&target), _isConnected(true) {}
+
+  /// Connect or disconnect the target. Writes to a disconnected target fail.
+  ///
+  void setConnected(bool isConnected) { _isConnected = isConnected; }
+
+public: // Implement AS1130Bus
+  virtual void beginTransmission(uint8_t chipAddress) override { _target->beginTransmission(chipAddress); }
+  virtual bool write(uint8_t data) override
+  {
+    // The simulator processes each byte while it is written, so nothing is forwarded.
+    return _isConnected ? _target->write(data) : true;
+  }
+  virtual Status endTransmission() override
+  {
+    return _isConnected ? _target->endTransmission() : StatusAddressNack;
+  }
+  virtual uint8_t requestFrom(uint8_t chipAddress, uint8_t count) override
+  {
+    return _isConnected ? _target->requestFrom(chipAddress, count) : 0;
+  }
+  virtual uint8_t read() override { return _target->read(); }
+  virtual uint8_t getBufferSize() const override { return _target->getBufferSize(); }
+  virtual void delay(uint16_t milliseconds) override { _target->delay(milliseconds); }
+  virtual uint32_t getMicroseconds() const override { return _target->getMicroseconds(); }
+
+private:
+  AS1130Bus *_target; ///< The bus to the chip.
+  bool _isConnected; ///< If the target is connected.
+};
+
+
+/// The callback added after the last transmission.
+///
+void onQueueDone(void *context, AS1130Bus::Status status)
+{
+  CallbackState *state = static_cast<CallbackState*>(context);
+  state->isCalled = true;
+  state->status = status;
+  state->transactionCount = state->recordingBus->getTransactionCount();
+  if (status != AS1130Bus::StatusSuccess) {
+    // The queued writes are already recorded in the state of the chip instance.
+    state->ledDriver->invalidateChipState();
+  }
+}
+
+
+/// Test the scheduling of a chip setup through the queue.
+///
+void testScheduling()
+{
+  AS1130Simulator simulator;
+  simulator.setBusFrequency(400000);
+  AS1130RecordingBus recordingBus(&simulator);
+  uint8_t queueBuffer[512];
+  AS1130TransactionQueue queue(recordingBus, queueBuffer, sizeof(queueBuffer));
+  AS1130 ledDriver(queue);
+  ledDriver.setControlRegisterCacheEnabled(true);
+
+  ledDriver.resetChip();
+  const std::size_t resetTransactionCount = queue.isEmpty() ? 0 : 1;
+  ledDriver.setRamConfiguration(AS1130::RamConfiguration1);
+  AS1130Picture24x5 picture;
+  for (uint8_t x = 0; x < AS1130Picture24x5::getWidth(); ++x) {
+    picture.setPixel(x, x % AS1130Picture24x5::getHeight(), true);
+  }
+  ledDriver.setOnOffFrame(0, picture);
+  ledDriver.setBlinkAndPwmSetAll(0);
+  ledDriver.setCurrentSource(AS1130::Current30mA);
+  ledDriver.setScanLimit(AS1130::ScanLimitFull);
+  ledDriver.startPicture(0);
+  ledDriver.startChip();
+  CallbackState callbackState = {false, AS1130Bus::StatusSuccess, 0, &recordingBus, &ledDriver};
+  queue.addCallback(&onQueueDone, &callbackState);
+  check(resetTransactionCount == 1, "resetChip() queues the reset");
+  check(recordingBus.getTransactionCount() == 0, "the setup returns without a transaction on the bus");
+  check(simulator.getTime() == 0, "the setup does not wait for the bus");
+  check(ledDriver.getLastError() == AS1130Bus::StatusSuccess, "the setup reports no error");
+
+  uint32_t currentTime = 0;
+  std::vector<uint32_t> sendTimes;
+  bool isOnePerPoll = true;
+  uint32_t pollCount = 0;
+  while (pollCount < cMaximumPollCount) {
+    const std::size_t countBefore = recordingBus.getTransactionCount();
+    const bool hasMoreEntries = queue.poll(currentTime);
+    const std::size_t countAfter = recordingBus.getTransactionCount();
+    if (countAfter - countBefore > 1) {
+      isOnePerPoll = false;
+    }
+    sendTimes.resize(countAfter, currentTime);
+    if (!hasMoreEntries) {
+      break;
+    }
+    ++pollCount;
+    ++currentTime;
+    simulator.advanceTime(1000);
+  }
+  // The reset is the write of zero to the shutdown register, followed by the delay.
+  const AS1130RecordingBus::TransactionList &transactions = recordingBus.getTransactions();
+  std::size_t resetIndex = 0;
+  while (resetIndex + 1 < transactions.size() && !(transactions[resetIndex].data.size() == 2
+      && transactions[resetIndex].data[0] == AS1130::CR_ShutdownAndOpenShort
+      && transactions[resetIndex].data[1] == 0x00)) {
+    ++resetIndex;
+  }
+  check(resetIndex + 1 < transactions.size(), "the reset is followed by other transmissions");
+  const uint32_t resetTime = sendTimes[resetIndex];
+  const uint32_t afterResetTime = sendTimes[resetIndex + 1];
+  std::printf("       reset sent at %lu ms, next transmission at %lu ms, %lu transactions\n",
+    static_cast<unsigned long>(resetTime), static_cast<unsigned long>(afterResetTime),
+    static_cast<unsigned long>(recordingBus.getTransactionCount()));
+  check(queue.isEmpty(), "the queue is empty after polling");
+  check(isOnePerPoll, "each poll sends at most one transmission");
+  check(afterResetTime - resetTime >= cResetDelay, "the reset delay is not shortened");
+  check(afterResetTime - resetTime <= cResetDelay + 1, "the transmission after the reset delay is sent at once");
+  check(callbackState.isCalled, "the callback is called");
+  check(callbackState.status == AS1130Bus::StatusSuccess, "the callback reports success");
+  check(callbackState.transactionCount == recordingBus.getTransactionCount(), "the callback is called after the last transmission");
+  std::size_t readCount = 0;
+  for (const AS1130RecordingBus::Transaction &transaction : transactions) {
+    if (transaction.type == AS1130RecordingBus::TransactionRead) {
+      ++readCount;
+    }
+  }
+  check(readCount == 0, "no read flushes the queue");
+
+  uint8_t brightness[0xc0];
+  simulator.render(brightness);
+  bool isPictureCorrect = true;
+  for (uint8_t x = 0; x < AS1130Picture24x5::getWidth(); ++x) {
+    for (uint8_t y = 0; y < AS1130Picture24x5::getHeight(); ++y) {
+      const bool isOn = (brightness[AS1130::getLedIndex24x5(x, y)] != 0);
+      if (isOn != picture.getPixel(x, y)) {
+        isPictureCorrect = false;
+      }
+    }
+  }
+  check(isPictureCorrect, "the chip shows the picture");
+}
+
+
+/// Test the recovery after a failed deferred frame write.
+///
+void testFailedDeferredWrite()
+{
+  AS1130Simulator simulator;
+  AS1130RecordingBus recordingBus(&simulator);
+  DisconnectableBus disconnectableBus(recordingBus);
+  uint8_t queueBuffer[128];
+  AS1130TransactionQueue queue(disconnectableBus, queueBuffer, sizeof(queueBuffer));
+  AS1130 ledDriver(queue);
+  uint8_t frameShadow[AS1130FrameData::cSize];
+  ledDriver.setFrameShadow(frameShadow, 1);
+  AS1130FrameData frameData = {};
+  for (uint8_t i = 0; i < AS1130FrameData::cSize; ++i) {
+    frameData.registers[i] = static_cast<uint8_t>(0x11 * i + 1);
+  }
+
+  disconnectableBus.setConnected(false);
+  ledDriver.setOnOffFrameRaw(0, frameData);
+  CallbackState callbackState = {false, AS1130Bus::StatusSuccess, 0, &recordingBus, &ledDriver};
+  queue.addCallback(&onQueueDone, &callbackState);
+  check(ledDriver.getLastError() == AS1130Bus::StatusSuccess, "a deferred write reports success first");
+  queue.flush();
+  check(callbackState.isCalled && callbackState.status != AS1130Bus::StatusSuccess,
+    "the callback reports the failed deferred write");
+
+  disconnectableBus.setConnected(true);
+  ledDriver.setOnOffFrameRaw(0, frameData);
+  queue.flush();
+  bool isFrameOnChip = true;
+  for (uint8_t i = 0; i < AS1130FrameData::cSize; ++i) {
+    if (simulator.getMemory(AS1130::RS_OnOffFrame, i) != frameData.registers[i]) {
+      isFrameOnChip = false;
+    }
+  }
+  check(isFrameOnChip, "writing the frame again after invalidateChipState() restores it");
+}
+
+
+/// Test a transmission which can never fit into the buffer.
+///
+void testOversizedTransmission()
+{
+  AS1130Simulator simulator;
+  AS1130RecordingBus recordingBus(&simulator);
+  uint8_t queueBuffer[16];
+  AS1130TransactionQueue queue(recordingBus, queueBuffer, sizeof(queueBuffer));
+  queue.beginTransmission(0x30);
+  bool isWritten = true;
+  for (uint8_t i = 0; i < 20; ++i) {
+    isWritten &= queue.write(i);
+  }
+  check(isWritten, "the transmission is written");
+  check(queue.endTransmission() == AS1130Bus::StatusDataTooLong, "an oversized transmission is rejected");
+  queue.flush();
+  check(recordingBus.getTransactionCount() == 0, "an oversized transmission is not sent");
+}
+
+
+}
+
+
+int main()
+{
+  testScheduling();
+  testFailedDeferredWrite();
+  testOversizedTransmission();
+  if (gFailureCount != 0) {
+    std::printf("FAILED\n");
+    return 1;
+  }
+  std::printf("OK\n");
+  return 0;
+}
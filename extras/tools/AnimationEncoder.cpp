@@ -0,0 +1,267 @@
+//
+// Lucky Resistor's AS1130 Library
+// ---------------------------------------------------------------------------
+// (c)2017 by Lucky Resistor. See LICENSE for details.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>
+//
+//
+// Encoder for compressed animations.
+//
+// This program runs on the host and converts a text file with animation frames
+// into the compressed format read by AS1130AnimationDecoder. The result is
+// written as C++ source with the data stored in program memory.
+//
+// The input file contains one frame after the other, separated by empty lines.
+// Each line of a frame is one row of pixels, where `#`, `X` and `1` are lit
+// pixels and all other characters dark pixels. Lines starting with `;` are
+// comments.
+//
+// Build and run from the root of the library:
+//
+//   c++ -std=c++11 -O2 -I. extras/tools/AnimationEncoder.cpp LRAS1130*.cpp -o AnimationEncoder
+//   ./AnimationEncoder [--12x11] [--pwm <index>] [--name <name>] <input> > animation.h
+//
+#include "LRAS1130.h"
+#include "LRAS1130AnimationDecoder.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+using namespace lr;
+
+
+namespace {
+
+
+/// The register images of all frames.
+///
+typedef std::vector<AS1130FrameData> FrameList;
+
+
+/// Check if a character is a lit pixel.
+///
+bool isPixelSet(char c)
+{
+  return c == '#' || c == 'X' || c == '1';
+}
+
+
+/// Convert the lines of one frame into a register image.
+///
+template<typename Picture>
+AS1130FrameData convertFrame(const std::vector<std::string> &lines, uint8_t pwmSetIndex)
+{
+  Picture picture;
+  for (uint8_t y = 0; y < Picture::getHeight() && y < lines.size(); ++y) {
+    const std::string &line = lines[y];
+    for (uint8_t x = 0; x < Picture::getWidth() && x < line.size(); ++x) {
+      picture.setPixel(x, y, isPixelSet(line[x]));
+    }
+  }
+  AS1130FrameData frameData;
+  Picture::writeRegisters(frameData.registers, picture.getData(), pwmSetIndex);
+  return frameData;
+}
+
+
+/// Read all frames from a text file.
+///
+template<typename Picture>
+bool readFrames(const char *path, uint8_t pwmSetIndex, FrameList &frames)
+{
+  std::ifstream input(path);
+  if (!input) {
+    std::fprintf(stderr, "Could not open %s\n", path);
+    return false;
+  }
+  std::vector<std::string> lines;
+  std::string line;
+  bool isEnd = false;
+  while (!isEnd) {
+    isEnd = !std::getline(input, line);
+    if (!isEnd && !line.empty() && line[0] == ';') {
+      continue;
+    }
+    if (!isEnd && !line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (isEnd || line.empty()) {
+      if (!lines.empty()) {
+        if (lines.size() != Picture::getHeight()) {
+          std::fprintf(stderr, "Frame %u has %u lines instead of %u.\n",
+            static_cast<unsigned>(frames.size()), static_cast<unsigned>(lines.size()), Picture::getHeight());
+          return false;
+        }
+        frames.push_back(convertFrame<Picture>(lines, pwmSetIndex));
+        lines.clear();
+      }
+    } else {
+      lines.push_back(line);
+    }
+  }
+  return true;
+}
+
+
+/// Encode the delta between two frames.
+///
+void encodeFrame(const AS1130FrameData &previous, const AS1130FrameData &current, std::vector<uint8_t> &output)
+{
+  uint8_t delta[AS1130FrameData::cSize];
+  for (uint8_t i = 0; i < AS1130FrameData::cSize; ++i) {
+    delta[i] = previous.registers[i] ^ current.registers[i];
+  }
+  uint8_t index = 0;
+  while (index < AS1130FrameData::cSize) {
+    uint8_t length = 0;
+    if (delta[index] == 0) {
+      while (index + length < AS1130FrameData::cSize && delta[index + length] == 0) {
+        ++length;
+      }
+      output.push_back(AS1130AnimationDecoder::cTokenSkip | (length - 1));
+    } else {
+      // A single unchanged byte is cheaper as part of the literal than a skip token.
+      while (index + length < AS1130FrameData::cSize) {
+        if (delta[index + length] != 0) {
+          ++length;
+        } else if (index + length + 1 < AS1130FrameData::cSize && delta[index + length + 1] != 0) {
+          length += 2;
+        } else {
+          break;
+        }
+      }
+      output.push_back(length - 1);
+      output.insert(output.end(), delta + index, delta + index + length);
+    }
+    index += length;
+  }
+}
+
+
+/// Encode all frames.
+///
+std::vector<uint8_t> encodeAnimation(const FrameList &frames)
+{
+  std::vector<uint8_t> output;
+  output.push_back(AS1130AnimationDecoder::cFormatVersion);
+  output.push_back(static_cast<uint8_t>(frames.size()));
+  output.push_back(static_cast<uint8_t>(frames.size() >> 8));
+  AS1130FrameData previous;
+  std::memset(previous.registers, 0, AS1130FrameData::cSize);
+  for (const AS1130FrameData &frame : frames) {
+    encodeFrame(previous, frame, output);
+    previous = frame;
+  }
+  return output;
+}
+
+
+/// Decode the data with the library decoder and compare it with the frames.
+///
+bool verifyAnimation(const std::vector<uint8_t> &data, const FrameList &frames)
+{
+  AS1130AnimationDecoder decoder;
+  if (!decoder.begin(data.data()) || decoder.getFrameCount() != frames.size()) {
+    return false;
+  }
+  AS1130FrameData frameData;
+  for (const AS1130FrameData &frame : frames) {
+    if (!decoder.decodeNextFrame(frameData)
+      || std::memcmp(frameData.registers, frame.registers, AS1130FrameData::cSize) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/// Write the data as C++ source.
+///
+void writeSource(const char *name, const std::vector<uint8_t> &data, size_t frameCount)
+{
+  std::printf("// Generated by AnimationEncoder: %u frames, %u bytes (%u bytes uncompressed).\n",
+    static_cast<unsigned>(frameCount), static_cast<unsigned>(data.size()),
+    static_cast<unsigned>(frameCount * AS1130FrameData::cSize));
+  std::printf("const uint8_t %s[] PROGMEM = {", name);
+  for (size_t i = 0; i < data.size(); ++i) {
+    if ((i % 12) == 0) {
+      std::printf("\n ");
+    }
+    std::printf(" 0x%02x%s", data[i], (i + 1 < data.size()) ? "," : "");
+  }
+  std::printf("};\n");
+}
+
+
+void printUsage()
+{
+  std::fprintf(stderr, "Usage: AnimationEncoder [--12x11] [--pwm <index>] [--name <name>] <input>\n");
+}
+
+
+}
+
+
+int main(int argc, char *argv[])
+{
+  bool is12x11 = false;
+  uint8_t pwmSetIndex = 0;
+  const char *name = "animationData";
+  const char *path = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--12x11") == 0) {
+      is12x11 = true;
+    } else if (std::strcmp(argv[i], "--pwm") == 0 && i + 1 < argc) {
+      pwmSetIndex = static_cast<uint8_t>(std::atoi(argv[++i]) & 0x7);
+    } else if (std::strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+      name = argv[++i];
+    } else if (argv[i][0] != '-' && path == nullptr) {
+      path = argv[i];
+    } else {
+      printUsage();
+      return 1;
+    }
+  }
+  if (path == nullptr) {
+    printUsage();
+    return 1;
+  }
+
+  FrameList frames;
+  const bool isRead = is12x11
+    ? readFrames<AS1130Picture12x11>(path, pwmSetIndex, frames)
+    : readFrames<AS1130Picture24x5>(path, pwmSetIndex, frames);
+  if (!isRead) {
+    return 1;
+  }
+  if (frames.empty() || frames.size() > 0xffff) {
+    std::fprintf(stderr, "The animation has to contain between 1 and 65535 frames.\n");
+    return 1;
+  }
+
+  const std::vector<uint8_t> data = encodeAnimation(frames);
+  if (!verifyAnimation(data, frames)) {
+    std::fprintf(stderr, "ERROR: The decoded animation differs from the input.\n");
+    return 1;
+  }
+  writeSource(name, data, frames.size());
+  return 0;
+}